@@ -15,7 +15,7 @@
                   
       Erstellt:   09.04.2021
                   
-      Geändert:   19.04.2021
+      Geändert:   16.10.2026
 
       -----------------------------------------------------------------------
 
@@ -46,6 +46,13 @@
 
            4. Zell-zentriertes Gitter
 
+           5. Upwind-Massenströme, wahlweise mit TVD-Begrenzer 2. Ordnung
+              (Deferred Correction)
+
+           6. Alternativ konservativ Semi-Lagrange ohne Gleichungssystem
+
+           7. Optional parallel in der Zeit (Parareal, Zeitscheiben je Thread)
+
       -----------------------------------------------------------------------
 
       Folgende Randbedingungen sind implementiert:
@@ -56,7 +63,34 @@
            4. Periodische Randbedingung
            5. Dynamische Randbedingung
            6. Strömungsausgang
-      
+
+      -----------------------------------------------------------------------
+
+      Folgende Löser für das lineare Gleichungssystem sind implementiert:
+
+           1. Gauß-Seidel Iteration
+           2. Thomas-Algorithmus (zyklisch bei periodischen Rändern)
+           3. Partitionierter Thomas-Algorithmus für mehrere Threads
+              (mit OpenMP übersetzen, z.B. g++ -O2 -fopenmp -pthread konti.cpp)
+           4. Rot-Schwarz SOR mit geschätztem Relaxationsfaktor
+           5. Geometrisches Mehrgitterverfahren (V- oder F-Zyklus)
+           6. BiCGSTAB und GMRES(m) mit Jacobi- oder ILU(0)-Vorkonditionierung
+
+      -----------------------------------------------------------------------
+
+      Aufruf:
+
+           konti                          Einzelner Lauf mit input.dat
+           konti studie.dat [Arbeiter]    Parameterstudie: jede Zeile
+                                          "<Ordner> Name=Wert ..." ist ein
+                                          Fall auf Basis von input.dat
+           konti -s [Socket]              Dienst: Fälle "Name=Wert ..." von
+                                          stdin oder einem Unix-Socket,
+                                          Ergebnisse binär zurück
+
+      Mit -DKONTI_BIBLIOTHEK übersetzt entfällt main, die Schnittstelle für
+      andere Programme steht in konti.h.
+
       ----------------------------------------------------------------------- */
 
    /* Header Dateien einbinden */
@@ -67,6 +101,25 @@
      #include <string>
      #include <stdlib.h>
      #include <math.h>
+     #include <atomic>
+     #include <thread>
+     #include <chrono>
+     #include <mutex>
+     #include <condition_variable>
+     #include <string.h>
+     #include <stdio.h>
+     #include <sstream>
+     #include <map>
+     #include <vector>
+     #include <deque>
+     #include <sys/stat.h>
+     #include <sys/socket.h>
+     #include <sys/un.h>
+     #include <unistd.h>
+     #include <signal.h>
+     #include <climits>
+
+     #include "konti.h"
 
    /* ----------------------------------------------------------------------- */
 
@@ -78,45 +131,153 @@
 
    /* Versionsnummer definieren */
 
-      string CppVersion = "19.04.2021";
+      string CppVersion = "16.10.2026";
+
+   /* ----------------------------------------------------------------------- */
+
+   /* Koeffizienten und Zerlegungen, die sich die Läufe einer
+      Parameterstudie teilen (siehe KoeffizientenTeilen) */
+
+      struct Koeffizientenspeicher
+     {
+      mutex m;                           // Schutz für Satz
+      map< string, vector<double> > Satz; // Schlüssel: a0*dt, Ränder, x, dx, u
+     };
 
    /* ----------------------------------------------------------------------- */
 
+   /* Zustand eines Rechenlaufs: Parameter, Felder und Funktionen. Jeder
+      Lauf hat seinen eigenen Kontext, so können mehrere Läufe in einem
+      Prozess nebeneinander rechnen (siehe StudieDurchfuehren). Anlegen
+      mit new Kontext(), damit alle Zeiger zunächst NULL sind. */
+
+      struct Kontext
+     {
+
    /* Funktionsprototypen deklarieren */
 
+     ~Kontext                       (void);
+
       void StartmeldungAusgeben     (void);
       void ParameterEinlesen        (void);
       void SimulationVorbereiten    (void);
       void ParameterAusgeben        (void);
       void SimulationDurchfuehren   (void);
+      void ZeitschleifeStarten      (void);
+      void BibliothekVorbereiten    (void);
+      void Zeitschritt              (unsigned long);
+      unsigned long SchritteRechnen (unsigned long);
+      void PararealDurchfuehren     (void);
+      void PararealPropagieren      (int,double*,double,unsigned long);
       void ErgebnisseSpeichern      (void);
       void ErgebnisseDarstellen     (void);
       void ProgrammBeenden          (void);
                                     
-      void MasseBerechnen           (void);
-      void EkinBerechnen            (void);
-      void ImpulsBerechnen          (void);
+      void FeldgruppenVorbereiten   (void);
+      void FeldgruppenKoeffizienten (void);
+      void FeldgruppenZeitschritt   (void);
+      void FeldgruppeRechteSeite    (int);
+      void FeldgruppeKorrektur      (int);
+      void FeldgruppeLoesen         (int);
+      void FeldgruppeSemiLagrange   (int);
+      void FeldgruppenMasseSchreiben(ofstream&,ofstream&,double);
+      void FeldgruppenSpeichern     (void);
+      void FelderSpeichern          (int,int,const char*,const char*);
+      void FelderEinlesen           (int,int,const char*,const char*);
+
+      void DefektProtokollStarten   (void);
+      void DefektProtokollBeenden   (void);
+      void DefektSpeichern          (double);
+      void DefektSchreiber          (void);
+
+      void CheckpointStarten        (void);
+      void CheckpointBeenden        (void);
+      void CheckpointSchreiben      (unsigned long);
+      void CheckpointSchreiber      (void);
+      void CheckpointEinlesen       (void);
+      size_t CheckpointLaenge       (void);
+
+      unsigned long long GitterPruefsumme (void);
+
+      void DiagnoseBerechnen        (void);
                                     
-      void (*HilfsfelderBerechnen ) (void);
-      void (*ImpliziterZeitschritt) (void);
+      void (Kontext::*HilfsfelderBerechnen ) (void);
+      void (Kontext::*Faktorisieren        ) (void);
+      void (Kontext::*ImpliziterZeitschritt) (void);
 
 
       void HilfsfelderBerechnenPBC  (void);
       void HilfsfelderBerechnenSTD  (void);
+
+      void FaktorisierenPBC         (void);
+      void FaktorisierenSTD         (void);
+      void FaktorisierenPAR         (void);
+      void RelaxationSchaetzen      (void);
+      void MehrgitterAnlegen        (void);
+      void MehrgitterAufbauen       (void);
+      void MehrgitterGlaetten       (int,int);
+      void MehrgitterZyklus         (int,int);
+
+      void KrylovAnlegen            (void);
+      void KrylovAufbauen           (void);
+      void OperatorAnwenden         (double*,double*);
+      double Skalarprodukt          (double*,double*);
+      double Residuum               (double*,double*,double*);
+
+      void (Kontext::*Vorkonditionieren) (double*,double*);
+      void (Kontext::*KrylovLoeser     ) (void);
+
+      void VorkonditionierenOhne    (double*,double*);
+      void VorkonditionierenJAC     (double*,double*);
+      void VorkonditionierenILU     (double*,double*);
+      void KrylovBiCGSTAB           (void);
+      void KrylovGMRES              (void);
+
+      void KoeffizientenAktualisieren (void);
+      void KoeffizientenTeilen      (void);
+
+      void ZeitebenenSpeichern      (void);
+      void AbbruchschrankeBerechnen (void);
+      void ZeitschrittWaehlen       (void);
+      void ZeitverfahrenWaehlen     (void);
+      void ExtrapolationWaehlen     (void);
+      void RechteSeiteBerechnen     (void);
+      void KorrekturZeitschritt     (void);
+      void KorrekturBerechnen       (double*,int,bool);
+      void AbfahrtspunkteBerechnen  (void);
+      void SemiLagrangeZeitschritt  (void);
+      void SemiLagrangeTransport    (double*,int,double*,double*);
+      double ZuflussIntegral        (double*,double,double,int);
+      bool ZeitschrittAnnehmen      (void);
+      void VorhersageBerechnen      (void);
+      void StartwertSetzen          (void);
+      void EinsparungSchaetzen      (void);
+      bool Abbrechen                (double);
+      void KonvergenzrateSchaetzen  (void);
+      double ResiduumFeld           (void);
                                     
-      void ImpliziterZeitschrittPBC (void);
-      void ImpliziterZeitschrittSTD (void);
+      template <int W, int O>
+      void ImpliziterZeitschrittGS  (void);
+      template <int W, int O>
+      void ImpliziterZeitschrittWF  (void);
+      void ImpliziterZeitschrittTDMA(void);
+      void ImpliziterZeitschrittZYK (void);
+      void ImpliziterZeitschrittPAR (void);
+      void ImpliziterZeitschrittRB  (void);
+      void ImpliziterZeitschrittMG  (void);
+      void ImpliziterZeitschrittKRY (void);
                                     
       void SetGradient              (double*,int,double);
       void GetGradient              (double*,int,double&);
                                     
       void RandbedingungAusgeben    (int,char*);
+      void LoeserAusgeben           (int,char*);
       void FunktionsNameAusgeben    (int,char*);
                                     
-      double (*U0)                  (double);
-      double (*R0)                  (double);
-      double (*W0)                  (double);
-      double (*O0)                  (double);
+      double (Kontext::*U0)         (double);
+      double (Kontext::*R0)         (double);
+      double (Kontext::*W0)         (double);
+      double (Kontext::*O0)         (double);
                                     
       double Konstante              (double);
       double Linear                 (double);
@@ -135,12 +296,16 @@
       double CosPeak                (double);
       double UserDefined01          (double);
       double UserDefined02          (double);
-                                    
-      double VolumenIntegration     (double*);
+
+      double (Kontext::*Begrenzer)  (double,double);
+
+      double Minmod                 (double,double);
+      double VanLeer                (double,double);
+      double Superbee               (double,double);
 
    /* ------------------------------------------------------------------ */
 
-   /* Globale Variablen deklarieren */
+   /* Variablen deklarieren */
 
       double xa;     // Linke Intervallgrenze
       double xe;     // Rechte Intervallgrenze
@@ -148,7 +313,22 @@
       double t0;     // Globaler Anfangszeitpunkt der Simulation
       double ta;     // Lokaler Anfangszeitpunkt der Simulation
       double te;     // Endzeitpunkt der Simulation
-      double dt;     // Länge des Zeitschritts
+      double dt;     // Länge des Zeitschritts (bei ZA = 1 des aktuellen)
+      double tol;    // Zulässiger lokaler Zeitfehler relativ zu max|rho| (ZA = 1)
+      double dtmin;  // Kleinste Schrittweite (ZA = 1)
+      double dtmax;  // Größte Schrittweite (ZA = 1)
+      double CFL;    // Größte Courant-Zahl (ZA = 1, 0 = ohne Grenze)
+      double tS;     // Zeitpunkt vor dem aktuellen Schritt (ZA = 1)
+      double dtV;    // Zuletzt angenommene Schrittweite
+      double dtN;    // Vorgeschlagene nächste Schrittweite (ZA = 1)
+      double dtK;    // Kleinste angenommene Schrittweite (ZA = 1)
+      double dtG;    // Größte angenommene Schrittweite (ZA = 1)
+      double dtVV;   // Vorletzte angenommene Schrittweite
+      double th;     // Theta des Theta-Verfahrens (ZV = 2)
+      double a0;     // Faktor vor dt in der Koeffizientenmatrix (Euler: 1)
+      double bA, bB; // BDF2: rechte Seite bA rho^n - bB rho^(n-1)
+      double wL;     // Lineare Extrapolation rho^n + wL (rho^n - rho^(n-1))
+      double lA, lB, lC; // Quadratische Extrapolation lA rho^n + lB rho^(n-1) + lC rho^(n-2)
       double Pi;     // Kreiszahl Pi
 
       double dxrhoW; // x-Ableitung von rho auf Westrand
@@ -186,6 +366,13 @@
                      
       int IMAX ;     // Maximale Anzahl der Gauß-Seidel Iterationen
       int NMAX ;     // Zähler für: IMAX erreicht!
+      int KS   ;     // Innere Iterationen im aktuellen Zeitschritt
+      int DL   ;     // Protokoll des Defekts
+      int WF   ;     // Gauß-Seidel Iterationen je Cache-Block (Wellenfront)
+      int MZ   ;     // Mehrgitter-Zyklus (0 = V, 1 = F)
+      int PK   ;     // Vorkonditionierer der Krylov-Löser
+      int LS   ;     // Löser für das Gleichungssystem
+      int NT   ;     // Anzahl der Threads
                      
       int RBW  ;     // Randbedingung am Westrand
       int RBO  ;     // Randbedingung am Ostrand
@@ -194,31 +381,215 @@
       int oF   ;     // Randfunktion Ost  für rho
       int uF   ;     // Anfangsfunktion für u
       int rF   ;     // Anfangsfunktion für rho
+      int EM   ;     // Anzahl der Ensemble-Mitglieder
+      int NS   ;     // Anzahl zusätzlicher Skalare
       int ED   ;     // Ergebnisse darstellen
       int AZ   ;     // Anfangszustand
+      int CP   ;     // Checkpoint alle CP Zeitschritte
+      int NA   ;     // Ausgabe alle NA Zeitschritte (0 = automatisch)
                      
-      double delta;  // Absolute Genauigkeit für den Defekt
+      double delta;  // Genauigkeit für den Defekt (siehe SK)
+      double dS;     // Abbruchschranke im aktuellen Zeitschritt
+      double DV;     // Defekt der vorherigen inneren Iteration
+      double qS;     // Obere Schranke der Konvergenzrate des Lösers (SK = 3)
+      int    SK;     // Abbruchkriterium der inneren Iterationen
+      int    nA;     // Anzahl gültiger Zeitebenen rhoA, rhoB, rhoC (höchstens 3)
+      int    PR;     // Prädiktor für den Startwert der inneren Iterationen
+      int    ZA;     // Zeitschrittsteuerung (0 = fest, 1 = adaptiv)
+      int    ZV;     // Zeitverfahren (0 = Euler, 1 = BDF2, 2 = Theta, 3 = Semi-Lagrange)
+      int    TV;     // Begrenzer der Massenströme (0 = Upwind 1. Ordnung)
+      int    DK;     // Durchgänge der Deferred Correction je Zeitschritt (TV > 0)
+      double KE;     // Summe der geschätzten eingesparten Iterationen (PR > 0)
+      int    PZ;     // Parareal: Anzahl der Zeitscheiben (0 = serielle Zeitschleife)
+      int    PI;     // Parareal: Höchstzahl der Iterationen
+      int    PG;     // Parareal: Grobe Zeitschritte je Zeitscheibe
+      int    PV;     // Parareal: Zusätzlich seriell rechnen und vergleichen (1)
+      double PT;     // Parareal: Zulässige Änderung relativ zu max|rho|
+
+      static constexpr double SKF = 0.01;  // SK = 3: Anteil des geschätzten Abschneidefehlers
+
+      double *Arena;  // Gemeinsamer Speicher aller Felder der Länge imax+2
+      int     LA;     // Auf eine Cache-Zeile aufgefüllte Feldlänge
 
       double *x ;    // Hilfsfeld
       double *dx;    // Hilfsfeld
+      double *dtdx;   // a0*dt/dx[i], wird mit den Koeffizienten berechnet
 
       double *u;      // Geschwindigkeitsfeld
       double *rho;    // Dichtefeld
                       
       double *f;      // Hilfsfeld
 
+      double *rhoA;   // rho zu Beginn des Zeitschritts (SK = 3, PR > 0)
+      double *rhoB;   // rho einen Zeitschritt früher
+      double *rhoC;   // rho zwei Zeitschritte früher
+      double *fS;     // Vorhergesagter Startwert (PR > 0)
+
+      double *rhoR;   // Rechte Seite ohne Korrektur (TV > 0)
+      double *fK;     // Korrektur des Massenstroms an der Ostseite der Zelle (TV > 0)
+
+      int    *dZ;     // Abfahrtszelle je Zellfläche (ZV = 3, 0 bzw. imax+1: Zufluss)
+      int    *dK;     // Umläufe der Charakteristik bei PBC (ZV = 3)
+      double *dA;     // Abstand zur Westseite der Abfahrtszelle bzw. Zuflussdauer (ZV = 3)
+      double *uN;     // u an Westrand, Zellmittelpunkten und Ostrand (ZV = 3)
+      double *xF;     // Ostseite der Zelle i, xF[imin-1] ist der Westrand (ZV = 3)
+      double  vW, vO; // Geschwindigkeit auf West- und Ostrand (ZV = 3)
+
       double *aW;     // Nebendiagonale der Koeffizientenmatrix
       double *aP;     // Hauptdiagonale der Koeffizientenmatrix
       double *aE;     // Nebendiagonale der Koeffizientenmatrix
+      double *raP;    // Kehrwerte der Hauptdiagonale (Gauß-Seidel)
+
+      double *cT;     // Multiplikatoren der LR-Zerlegung (Thomas)
+      double *rP;     // Reziproke Pivotelemente der LR-Zerlegung
+      double *zT;     // Korrekturvektor für Sherman-Morrison (PBC)
+
+      double zS;      // Nenner der Sherman-Morrison Korrektur
+      double vZ;      // Gewicht von f[imax] in der Sherman-Morrison Korrektur
+
+      double wR;      // Relaxationsfaktor für Rot-Schwarz SOR
+      double rJ;      // Geschätzter Spektralradius der Jacobi-Iteration
+
+      double *DW;     // Defekt je Iteration einer Wellenfront
+
+      static const int MGN = 16;   // Höchstens MGN Zellen auf dem gröbsten Gitter
+      static const int MGV =  2;   // Vor- und Nachglättungen je Gitter
+
+      int  nM ;       // Anzahl der Gitterebenen
+      int *nL ;       // Anzahl der Zellen je Ebene
+      int *oL ;       // Anfang einer Ebene in den Mehrgitterfeldern
+
+      double *gW, *gP, *gE;  // Koeffizientenmatrix je Ebene (Index 1..nL, Geister 0 und nL+1)
+      double *gQ;     // Kehrwerte der Hauptdiagonale je Ebene
+      double *gU;     // Lösung bzw. Korrektur je Ebene
+      double *gB;     // Rechte Seite je Ebene
+      double *gR;     // Residuum je Ebene
+      double *gA;     // LR-Zerlegung auf dem gröbsten Gitter
+      int    *gp;     // Zeilenvertauschungen auf dem gröbsten Gitter
+
+      static const int KM = 30;    // Restart-Länge von GMRES
+
+      double *kB;     // Rechte Seite des Krylov-Lösers
+      double *kD;     // Kehrwerte der Diagonale (Jacobi, Neumann eingerechnet)
+      double *kL;     // ILU(0): Multiplikatoren der unteren Nebendiagonale
+      double *kU;     // ILU(0): Kehrwerte der Diagonale von U
+      double *kV;     // Hilfsvektoren der Krylov-Löser
+      double *kH;     // GMRES: Hessenberg-Matrix, Givens-Rotationen, rechte Seite
+      double  kN;     // ILU(0) bei PBC: Multiplikator der Ecke aE[imax]
+      double  dWK;    // Neumann-Beitrag zur Diagonale am Westrand
+      double  dOK;    // Neumann-Beitrag zur Diagonale am Ostrand
+
+      double dtF;     // a0*dt der gespeicherten Zerlegung
+      long   VG ;     // Versionszähler für Gitter und Geschwindigkeitsfeld
+      long   VF ;     // Version der gespeicherten Zerlegung
+
+      int  nB ;       // Anzahl der Blöcke (partitionierter Löser)
+      int  nR ;       // Anzahl der Schnittstellen (reduziertes System)
+      int *iA ;       // Erste Zelle eines Blocks
+      int *iE ;       // Letzte Zelle eines Blocks (Schnittstelle)
+
+      double *rB;     // Reziproke Pivotelemente der Blockzerlegung
+      double *cB;     // Multiplikatoren der Blockzerlegung
+      double *vS;     // Spike: Einfluss der linken  Schnittstelle
+      double *wS;     // Spike: Einfluss der rechten Schnittstelle
+      double *AR;     // LR-Zerlegung des reduzierten Systems
+      double *bR;     // Rechte Seite und Lösung des reduzierten Systems
+      int    *pR;     // Zeilenvertauschungen des reduzierten Systems
 
       unsigned long int nmax ; // Anzahl der zeitlichen Teilintervalle
       unsigned long int N    ; // Jeder N-te Zeitschritt wird gespeichert
+      unsigned long int n0   ; // Zeitschritte vor dem Checkpoint (AZ = 2)
+      unsigned long int NR   ; // Verworfene Zeitschritte (ZA = 1)
+
+      struct Feldgruppe  // Zusatzfelder mit gleichen Randbedingungen
+     {
+      int RBW, RBO;      // Randbedingungen der Gruppe
+      int K;             // Anzahl der Felder der Gruppe
+      double *rho;       // Dichtefelder, je Zelle K Werte: rho[i*K+k]
+      double *p;         // Parameter je Feld (siehe FeldgruppenVorbereiten)
+      double *g;         // Gradienten am West- und Ostrand je Feld
+      double *rV;        // Vorherige Zeitebene (ZV = 1) bzw. rho^n (ZV = 2, TV > 0)
+      double *rR;        // Rechte Seite ohne Korrektur (TV > 0)
+      int *dZ, *dK;      // Abfahrtspunkte (ZV = 3)
+      double *dA;
+      double vW, vO;     // Geschwindigkeit auf den Rändern (ZV = 3)
+      double *s;         // Hilfsfeld je Feld
+      double *aW,*aP,*aE;// Koeffizientenmatrix
+      double *rP,*cT,*zT;// LR-Zerlegung und Sherman-Morrison Vektor
+      double zS, vZ;     // Sherman-Morrison Skalare
+     };
+
+      struct Propagator  // Zerlegung für Zeitschritte fester Länge (Parareal)
+     {
+      double dt;         // Schrittweite
+      double *aW,*aP,*aE;// Koeffizientenmatrix
+      double *rP,*cT,*zT;// LR-Zerlegung und Sherman-Morrison Vektor
+      double zS, vZ;     // Sherman-Morrison Skalare
+     };
+
+      Propagator PP[2];  // Feiner (0) und grober (1) Propagator
+
+      int nF;            // Anzahl der Zusatzfelder (Ensemble und Skalare)
+      int nG;            // Anzahl der Feldgruppen
+      Feldgruppe *FG;    // Feldgruppen
+      int *gF;           // Gruppe   des Zusatzfeldes
+      int *kF;           // Position des Zusatzfeldes in seiner Gruppe
+      double *mF;        // Aktuelle Masse je Zusatzfeld
 
       double M;       // Aktuelle Masse
       double Ek;      // Aktuelle kinetische Energie
       double px;      // Aktueller Impuls
 
+      static const int BD = 4096;  // Blocklänge der Diagnose-Summation
+      int     nD;     // Anzahl der Blöcke der Diagnose
+      double *DB;     // Teilsummen M, Ek, px je Block
+
       ofstream Dout;        // Ausgabeobjekt für Residuum
+
+      double DS;            // Defekt am Ende des aktuellen Zeitschritts
+      double KG;            // Summe der inneren Iterationen
+      double KP;            // Geschätzte eingesparte Iterationen im Zeitschritt
+
+      struct Ringpuffer     // Ringpuffer für den binären Defektverlauf
+     {
+      double *Wert;         // Puffer
+      size_t  Laenge;       // Kapazität (Zweierpotenz)
+      atomic<size_t> Kopf;  // Nächste Schreibposition des Lösers
+      atomic<size_t> Ende;  // Nächste Leseposition des Schreib-Threads
+      atomic<bool>   Aktiv; // Löser liefert noch Werte
+      thread Schreiber;     // Schreib-Thread
+      ofstream Datei;       // Ausgabedatei D.bin
+     };
+
+      Ringpuffer DR;        // Defektverlauf für DL = 2
+
+      struct Sicherung      // Doppelt gepufferter Checkpoint
+     {
+      char  *Puffer[2];     // Zwei Puffer für den Zustand
+      int    Status[2];     // 0 = frei, 1 = wartet, 2 = wird geschrieben
+      int    Aktuell;       // Nächster zu füllender Puffer
+      size_t Laenge;        // Größe eines Checkpoints in Byte
+      bool   Ende;          // Keine weiteren Checkpoints
+      mutex  m;             // Schutz für Status und Ende
+      condition_variable c; // Signal bei Statuswechsel
+      thread Schreiber;     // Schreib-Thread
+     };
+
+      Sicherung CS;         // Checkpoints für CP > 0
+
+      double *chkF;         // Zusatzfelder aus dem Checkpoint (AZ = 2)
+      double *chkG;         // Gradienten der Zusatzfelder aus dem Checkpoint
+      double *chkV;         // Vorherige Zeitebene der Zusatzfelder aus dem Checkpoint
+
+      ostream *Konsole = &cout;  // Bildschirmausgabe (Parameterstudie: konti.log)
+      string   Pfad;             // Verzeichnis der Ausgabedateien ("" = aktuelles)
+      string   Eingabe;          // Inhalt von input.dat (leer: Datei lesen)
+      const double *GitterDaten; // x und dx je Zelle aus mesh.dat (NULL: Datei lesen)
+      int      nGD;              // Anzahl der Werte in GitterDaten
+      Koeffizientenspeicher *Speicher;  // Gemeinsame Koeffizienten (NULL: ohne)
+      bool     Dateien = true;   // false: keine Ausgabedateien in SimulationVorbereiten (Bibliothek)
+      ostream  Stumm{nullptr};   // Verwirft alle Meldungen (Bibliothek ohne Meldungen)
+      unsigned long nK;          // Zeitschritte seit ZeitschleifeStarten (Bibliothek)
                             
       enum                  // Enum-Konstanten für RB
      {                      
@@ -229,48 +600,220 @@
       DynamicBoundary   ,   // = 4
       OutletBoundary        // = 5
      };                     
+
+      enum                  // Enum-Konstanten für DL
+     {
+      NoLog             ,   // = 0
+      StepLog           ,   // = 1
+      FullLog               // = 2
+     };
+
+      enum                  // Enum-Konstanten für SK
+     {
+      AbsoluteStop      ,   // = 0
+      RelativeStop      ,   // = 1
+      ResidualStop      ,   // = 2
+      AdaptiveStop          // = 3
+     };
+
+      enum                  // Enum-Konstanten für LS
+     {
+      GaussSeidelSolver ,   // = 0
+      ThomasSolver      ,   // = 1
+      ParallelSolver    ,   // = 2
+      RedBlackSolver    ,   // = 3
+      MultigridSolver   ,   // = 4
+      BiCGStabSolver    ,   // = 5
+      GMRESSolver           // = 6
+     };
+
+      enum                  // Enum-Konstanten für ZA
+     {
+      FixedTimeStep     ,   // = 0
+      AdaptiveTimeStep      // = 1
+     };
+
+      enum                  // Enum-Konstanten für ZV
+     {
+      ImplicitEuler     ,   // = 0
+      BDF2Scheme        ,   // = 1
+      ThetaScheme       ,   // = 2
+      SemiLagrangeScheme    // = 3
+     };
+
+      enum                  // Enum-Konstanten für TV
+     {
+      NoLimiter         ,   // = 0
+      MinmodLimiter     ,   // = 1
+      VanLeerLimiter    ,   // = 2
+      SuperbeeLimiter       // = 3
+     };
+
+      enum                  // Enum-Konstanten für PR
+     {
+      NoPredictor       ,   // = 0
+      LinearPredictor   ,   // = 1
+      QuadraticPredictor,   // = 2
+      UpwindPredictor       // = 3
+     };
+
+      enum                  // Enum-Konstanten für PK
+     {
+      NoPreconditioner  ,   // = 0
+      JacobiPreconditioner, // = 1
+      ILUPreconditioner     // = 2
+     };
                                                               
-      double (*Funktion[17]) (double) =  // Feld von Zeigern auf Funktionen
+      static const int FM = 16;  // Größter Index in Funktion (rF, uF, wF, oF)
+
+      double (Kontext::*Funktion[FM+1]) (double) =  // Feld von Zeigern auf Funktionen
      { 
-      Konstante,       //  =  0
-      Linear,          //  =  1
-      Parabel,         //  =  2
-      Rechteck,        //  =  3
-      Dreieck,         //  =  4
-      Saegezahn,       //  =  5
-      Linearrampe,     //  =  6
-      Cosinusrampe,    //  =  7
-      Sinus,           //  =  8
-      Cosinus,         //  =  9
-      Exponential,     //  = 10
-      Gauss,           //  = 11
-      Dirac,           //  = 12
-      Heaviside,       //  = 13
-      CosPeak,         //  = 14
-      UserDefined01,   //  = 15
-      UserDefined02    //  = 16
+      &Kontext::Konstante,       //  =  0
+      &Kontext::Linear,          //  =  1
+      &Kontext::Parabel,         //  =  2
+      &Kontext::Rechteck,        //  =  3
+      &Kontext::Dreieck,         //  =  4
+      &Kontext::Saegezahn,       //  =  5
+      &Kontext::Linearrampe,     //  =  6
+      &Kontext::Cosinusrampe,    //  =  7
+      &Kontext::Sinus,           //  =  8
+      &Kontext::Cosinus,         //  =  9
+      &Kontext::Exponential,     //  = 10
+      &Kontext::Gauss,           //  = 11
+      &Kontext::Dirac,           //  = 12
+      &Kontext::Heaviside,       //  = 13
+      &Kontext::CosPeak,         //  = 14
+      &Kontext::UserDefined01,   //  = 15
+      &Kontext::UserDefined02    //  = 16
+     };
+
+      void (Kontext::*ZeitschrittGS[6][6]) (void) =  // Gauß-Seidel Kernel je Paar (RBW,RBO)
+     {
+      { &Kontext::ImpliziterZeitschrittGS<0,0>, &Kontext::ImpliziterZeitschrittGS<0,1>, &Kontext::ImpliziterZeitschrittGS<0,2>,
+        &Kontext::ImpliziterZeitschrittGS<0,3>, &Kontext::ImpliziterZeitschrittGS<0,4>, &Kontext::ImpliziterZeitschrittGS<0,5> },
+      { &Kontext::ImpliziterZeitschrittGS<1,0>, &Kontext::ImpliziterZeitschrittGS<1,1>, &Kontext::ImpliziterZeitschrittGS<1,2>,
+        &Kontext::ImpliziterZeitschrittGS<1,3>, &Kontext::ImpliziterZeitschrittGS<1,4>, &Kontext::ImpliziterZeitschrittGS<1,5> },
+      { &Kontext::ImpliziterZeitschrittGS<2,0>, &Kontext::ImpliziterZeitschrittGS<2,1>, &Kontext::ImpliziterZeitschrittGS<2,2>,
+        &Kontext::ImpliziterZeitschrittGS<2,3>, &Kontext::ImpliziterZeitschrittGS<2,4>, &Kontext::ImpliziterZeitschrittGS<2,5> },
+      { &Kontext::ImpliziterZeitschrittGS<3,0>, &Kontext::ImpliziterZeitschrittGS<3,1>, &Kontext::ImpliziterZeitschrittGS<3,2>,
+        &Kontext::ImpliziterZeitschrittGS<3,3>, &Kontext::ImpliziterZeitschrittGS<3,4>, &Kontext::ImpliziterZeitschrittGS<3,5> },
+      { &Kontext::ImpliziterZeitschrittGS<4,0>, &Kontext::ImpliziterZeitschrittGS<4,1>, &Kontext::ImpliziterZeitschrittGS<4,2>,
+        &Kontext::ImpliziterZeitschrittGS<4,3>, &Kontext::ImpliziterZeitschrittGS<4,4>, &Kontext::ImpliziterZeitschrittGS<4,5> },
+      { &Kontext::ImpliziterZeitschrittGS<5,0>, &Kontext::ImpliziterZeitschrittGS<5,1>, &Kontext::ImpliziterZeitschrittGS<5,2>,
+        &Kontext::ImpliziterZeitschrittGS<5,3>, &Kontext::ImpliziterZeitschrittGS<5,4>, &Kontext::ImpliziterZeitschrittGS<5,5> }
+     };
+
+      void (Kontext::*ZeitschrittWF[6][6]) (void) =  // Wellenfront-Kernel je Paar (RBW,RBO)
+     {
+      { &Kontext::ImpliziterZeitschrittWF<0,0>, &Kontext::ImpliziterZeitschrittWF<0,1>, &Kontext::ImpliziterZeitschrittWF<0,2>,
+        &Kontext::ImpliziterZeitschrittWF<0,3>, &Kontext::ImpliziterZeitschrittWF<0,4>, &Kontext::ImpliziterZeitschrittWF<0,5> },
+      { &Kontext::ImpliziterZeitschrittWF<1,0>, &Kontext::ImpliziterZeitschrittWF<1,1>, &Kontext::ImpliziterZeitschrittWF<1,2>,
+        &Kontext::ImpliziterZeitschrittWF<1,3>, &Kontext::ImpliziterZeitschrittWF<1,4>, &Kontext::ImpliziterZeitschrittWF<1,5> },
+      { &Kontext::ImpliziterZeitschrittWF<2,0>, &Kontext::ImpliziterZeitschrittWF<2,1>, &Kontext::ImpliziterZeitschrittWF<2,2>,
+        &Kontext::ImpliziterZeitschrittWF<2,3>, &Kontext::ImpliziterZeitschrittWF<2,4>, &Kontext::ImpliziterZeitschrittWF<2,5> },
+      { &Kontext::ImpliziterZeitschrittWF<3,0>, &Kontext::ImpliziterZeitschrittWF<3,1>, &Kontext::ImpliziterZeitschrittWF<3,2>,
+        &Kontext::ImpliziterZeitschrittWF<3,3>, &Kontext::ImpliziterZeitschrittWF<3,4>, &Kontext::ImpliziterZeitschrittWF<3,5> },
+      { &Kontext::ImpliziterZeitschrittWF<4,0>, &Kontext::ImpliziterZeitschrittWF<4,1>, &Kontext::ImpliziterZeitschrittWF<4,2>,
+        &Kontext::ImpliziterZeitschrittWF<4,3>, &Kontext::ImpliziterZeitschrittWF<4,4>, &Kontext::ImpliziterZeitschrittWF<4,5> },
+      { &Kontext::ImpliziterZeitschrittWF<5,0>, &Kontext::ImpliziterZeitschrittWF<5,1>, &Kontext::ImpliziterZeitschrittWF<5,2>,
+        &Kontext::ImpliziterZeitschrittWF<5,3>, &Kontext::ImpliziterZeitschrittWF<5,4>, &Kontext::ImpliziterZeitschrittWF<5,5> }
+     };
+
+     };
+
+   /* ----------------------------------------------------------------------- */
+
+   /* Parameterstudie: viele Läufe in einem Prozess */
+
+      struct Warteschlange  // Fälle eines Arbeiters, andere stehlen von hinten
+     {
+      mutex m;              // Schutz für Fall
+      deque<int> Fall;      // Nummern der noch offenen Fälle
+     };
+
+      struct Studie         // Gemeinsame Daten aller Läufe einer Parameterstudie
+     {
+      vector<string> Verzeichnis;     // Ausgabeverzeichnis je Fall
+      vector<string> Aenderung;       // Geänderte Parameter je Fall ("Name=Wert ...")
+      string Basis;                   // Inhalt von input.dat
+      vector<double> Gitter;          // Inhalt von mesh.dat (x und dx je Zelle)
+      Koeffizientenspeicher Speicher; // Gemeinsame Koeffizienten und Zerlegungen
+      Warteschlange *W;               // Eine Warteschlange je Arbeiter
+      int nW;                         // Anzahl der Arbeiter
+      mutex Ausgabe;                  // Schutz für cout
+     };
+
+      void StudieDurchfuehren       (const char*,int);
+      void StudieArbeiter           (Studie*,int);
+      bool FallHolen                (Studie*,int,int&);
+      void FallRechnen              (Studie*,int);
+      bool ParameterAendern         (string&,const string&,string&);
+      bool ParameterZeile           (const string&,const string&,size_t&,size_t&);
+      bool ParameterPruefen         (const string&,string&);
+
+   /* Dienst: ein Prozess rechnet Fall für Fall von stdin oder einem Unix-Socket */
+
+      struct Dienst         // Zwischenspeicher über alle Fälle des Dienstes
+     {
+      string Basis;                          // Inhalt von input.dat
+      map< string, vector<double> > Gitter;  // Gelesene Gitterdateien je Name
+      Koeffizientenspeicher Speicher;        // Gemeinsame Koeffizienten und Zerlegungen
+      static const size_t SatzMax = 1024;    // Mehr Sätze: Speicher leeren
      };
 
+      void DienstDurchfuehren       (const char*);
+      void DienstVerbindung         (Dienst*,FILE*,FILE*);
+      void DienstFall               (Dienst*,const string&,FILE*);
+      bool DienstPruefen            (const string&,string&);
+      void DienstFehler             (FILE*,const string&);
+
    /* -----------------------------------------------------------------------
-      Anfang von main
+      Anfang von main (entfällt in der Bibliothek, siehe konti.h)
       ----------------------------------------------------------------------- */
 
-      int main(void)
+     #ifndef KONTI_BIBLIOTHEK
+
+      int main(int argc, char *argv[])
      {
 
-      StartmeldungAusgeben();
-      ParameterEinlesen();
-      SimulationVorbereiten();
-      ParameterAusgeben();
-      SimulationDurchfuehren();
-      ErgebnisseSpeichern();
-      ErgebnisseDarstellen();
-      ProgrammBeenden();
+      Kontext *K;  // Rechenlauf
+
+   /* Dienst: konti -s [Unix-Socket], ohne Socket über stdin und stdout */
+
+      if ( argc > 1 && strcmp(argv[1],"-s") == 0 )
+     {
+      DienstDurchfuehren( ( argc > 2 ) ? argv[2] : NULL );
+      return (0);
+     }
+
+   /* Parameterstudie: konti <Manifest> [Anzahl der Arbeiter] */
+
+      if ( argc > 1 )
+     {
+      StudieDurchfuehren( argv[1], ( argc > 2 ) ? atoi(argv[2]) : 0 );
+      return (0);
+     }
+
+      K = new Kontext();
+
+      K->StartmeldungAusgeben();
+      K->ParameterEinlesen();
+      K->SimulationVorbereiten();
+      K->ParameterAusgeben();
+      if ( K->PZ > 0 ) K->PararealDurchfuehren();
+      else             K->SimulationDurchfuehren();
+      K->ErgebnisseSpeichern();
+      K->ErgebnisseDarstellen();
+      K->ProgrammBeenden();
+
+      delete K;
 
       return (0);
 
      }
 
+     #endif
+
    /* -----------------------------------------------------------------------
       Ende von main
       ----------------------------------------------------------------------- */
@@ -281,12 +824,12 @@
       Anfang von StartmeldungAusgeben
       ----------------------------------------------------------------------- */
 
-      void StartmeldungAusgeben(void)
+      void Kontext::StartmeldungAusgeben(void)
      {
 
       system("clear");
 
-      cout << "\n                           * * * Kontinuitätsgleichung 1D * * *\n"
+      *Konsole << "\n                           * * * Kontinuitätsgleichung 1D * * *\n"
            << "\n                                   Version: " << CppVersion << "\n\n";
 
      }
@@ -301,14 +844,22 @@
       Anfang von ParameterEinlesen
       ----------------------------------------------------------------------- */
 
-      void ParameterEinlesen(void)
+      void Kontext::ParameterEinlesen(void)
      {
 
-      ifstream fin;       // Eingabeobjekt zum Lesen aus einer Datei
+      istringstream fin;  // Eingabeobjekt zum Lesen aus dem Inhalt von input.dat
 
       string InpVersion;  // Versionsnummer der Eingabedatei
 
-      fin.open("input.dat");
+      if ( Eingabe.empty() )  // Sonst von StudieDurchfuehren vorgegeben
+     {
+      ifstream fdat("input.dat");
+      ostringstream Inhalt;
+      Inhalt << fdat.rdbuf();
+      Eingabe = Inhalt.str();
+     }
+
+      fin.str(Eingabe);
 
                       fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
@@ -320,6 +871,13 @@
                       fin.ignore(80,'\n');
       fin >> ta;      fin.ignore(80,'\n');
       fin >> dt;      fin.ignore(80,'\n');
+      fin >> ZA;      fin.ignore(80,'\n');
+      fin >> tol;     fin.ignore(80,'\n');
+      fin >> dtmin;   fin.ignore(80,'\n');
+      fin >> dtmax;   fin.ignore(80,'\n');
+      fin >> CFL;     fin.ignore(80,'\n');
+      fin >> ZV;      fin.ignore(80,'\n');
+      fin >> th;      fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
       fin >> rF;      fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
@@ -355,23 +913,55 @@
                       fin.ignore(80,'\n');
       fin >> imax;    fin.ignore(80,'\n');
       fin >> nmax;    fin.ignore(80,'\n');
+      fin >> NA;      fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
       fin >> IMAX;    fin.ignore(80,'\n');
       fin >> delta;   fin.ignore(80,'\n');
+      fin >> SK;      fin.ignore(80,'\n');
+      fin >> LS;      fin.ignore(80,'\n');
+      fin >> NT;      fin.ignore(80,'\n');
+      fin >> DL;      fin.ignore(80,'\n');
+      fin >> WF;      fin.ignore(80,'\n');
+      fin >> MZ;      fin.ignore(80,'\n');
+      fin >> PK;      fin.ignore(80,'\n');
+      fin >> PR;      fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
       fin >> mesh;    fin.ignore(80,'\n');
+      fin >> TV;      fin.ignore(80,'\n');
+      fin >> DK;      fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
       fin >> RBW;     fin.ignore(80,'\n');
       fin >> RBO;     fin.ignore(80,'\n');
                       fin.ignore(80,'\n');
+      fin >> EM;      fin.ignore(80,'\n');
+      fin >> NS;      fin.ignore(80,'\n');
+                      fin.ignore(80,'\n');
       fin >> ED;      fin.ignore(80,'\n');
       fin >> AZ  ;    fin.ignore(80,'\n');
-
-      fin.close();
+      fin >> CP  ;    fin.ignore(80,'\n');
+                      fin.ignore(80,'\n');
+      fin >> PZ  ;    fin.ignore(80,'\n');
+      fin >> PI  ;    fin.ignore(80,'\n');
+      fin >> PG  ;    fin.ignore(80,'\n');
+      fin >> PT  ;    fin.ignore(80,'\n');
+      fin >> PV  ;    fin.ignore(80,'\n');
 
       if (!(CppVersion==InpVersion))  // Versionskontrolle
      {
-      cout << "\n >> Warnung: Unterschiedliche Versionsnummern in \"konti.cpp\" und \"input.dat\" !\n\n";
+      *Konsole << "\n >> Warnung: Unterschiedliche Versionsnummern in \"konti.cpp\" und \"input.dat\" !\n\n";
+      abort();
+     }
+
+      if ( RBW < WallBoundary || RBW > OutletBoundary ||
+           RBO < WallBoundary || RBO > OutletBoundary )
+     {
+      *Konsole << "\n >> Fehler: Unbekannte Randbedingung RBW oder RBO in \"input.dat\" !\n\n";
+      abort();
+     }
+
+      if ( TV < NoLimiter || TV > SuperbeeLimiter )
+     {
+      *Konsole << "\n >> Fehler: Unbekannter Begrenzer TV in \"input.dat\" !\n\n";
       abort();
      }
 
@@ -387,10 +977,10 @@
       Anfang von ParameterAusgeben
       ----------------------------------------------------------------------- */
 
-      void ParameterAusgeben(void)
+      void Kontext::ParameterAusgeben(void)
      {
 
-      cout << setiosflags(ios::left)
+      *Konsole << setiosflags(ios::left)
 
            << " xa   = " << setw(15) << xa
            << " xe   = " << setw(15) << xe
@@ -400,7 +990,16 @@
            << " ta   = " << setw(15) << ta
            << " te   = " << setw(15) << te
            << " dt   = " << setw(15) << dt
-           << " nmax = " << setw(15) << nmax << "\n\n"
+           << " nmax = " << setw(15) << nmax
+           << " N    = "             << N    << "\n\n"
+
+           << " ZA   = " << setw(15) << ZA
+           << " tol  = " << setw(15) << tol
+           << " dtmin= " << setw(15) << dtmin
+           << " dtmax= " << setw(15) << dtmax
+           << " CFL  = " << setw(15) << CFL
+           << " ZV   = " << setw(15) << ZV
+           << " th   = "             << th   << "\n\n"
 
            << " r1   = " << setw(15) << r1
            << " r2   = " << setw(15) << r2
@@ -430,18 +1029,39 @@
 
            << " t0   = " << setw(15) << t0
            << " ED   = " << setw(15) << ED
-           << " mesh = " << setw(15) << mesh << "\n\n"
+           << " mesh = " << setw(15) << mesh
+           << " TV   = " << setw(15) << TV
+           << " DK   = "             << DK   << "\n\n"
 
            << " IMAX = " << setw(15) << IMAX
-           << " delta= " << setw(15) << delta << "\n\n"
-
-           << " AZ   = " << setw(15) << AZ   << "\n\n";
+           << " delta= " << setw(15) << delta
+           << " SK   = " << setw(15) << SK
+           << " LS   = " << setw(15) << LS
+           << " NT   = " << setw(15) << NT
+           << " DL   = " << setw(15) << DL
+           << " WF   = " << setw(15) << WF
+           << " MZ   = " << setw(15) << MZ
+           << " PK   = " << setw(15) << PK
+           << " PR   = " << setw(15) << PR    << "\n\n"
+
+           << " AZ   = " << setw(15) << AZ
+           << " CP   = " << setw(15) << CP
+           << " EM   = " << setw(15) << EM
+           << " NS   = " << setw(15) << NS   << "\n\n"
+
+           << " PZ   = " << setw(15) << PZ
+           << " PI   = " << setw(15) << PI
+           << " PG   = " << setw(15) << PG
+           << " PT   = " << setw(15) << PT
+           << " PV   = "             << PV   << "\n\n";
 
    /* Randbedingungen und Funktionsnamen ausgeben */
 
       RandbedingungAusgeben(RBW,"RBW");
 
       RandbedingungAusgeben(RBO,"RBO");
+
+      LoeserAusgeben(LS,"LS ");
                                          if ( RBW == DynamicBoundary )
       FunktionsNameAusgeben(wF ,"wF" );
                                          if ( RBO == DynamicBoundary )
@@ -455,32 +1075,32 @@
 
       if ( RBW == DirichletBoundary && u[imin-1] < 0.0 )
      {
-      cout << "  >> Warnung: u(xa) < 0 ! (Reversed Flow)\n\n";
+      *Konsole << "  >> Warnung: u(xa) < 0 ! (Reversed Flow)\n\n";
      }
 
       if ( RBO == DirichletBoundary && u[imax+1] > 0.0 )
      {
-      cout << "  >> Warnung: u(xe) > 0 ! (Reversed Flow)\n\n";
+      *Konsole << "  >> Warnung: u(xe) > 0 ! (Reversed Flow)\n\n";
      }
 
       if ( RBW == NeumannBoundary && u[imin-1] < 0.0 )
      {
-      cout << "  >> Warnung: u(xa) < 0 ! (Reversed Flow)\n\n";
+      *Konsole << "  >> Warnung: u(xa) < 0 ! (Reversed Flow)\n\n";
      }
 
       if ( RBO == NeumannBoundary && u[imax+1] > 0.0 )
      {
-      cout << "  >> Warnung: u(xe) > 0 ! (Reversed Flow)\n\n";
+      *Konsole << "  >> Warnung: u(xe) > 0 ! (Reversed Flow)\n\n";
      }
 
       if ( RBW == OutletBoundary && u[imin] > 0.0 )
      {
-      cout << "  >> Warnung: u(xa) > 0 ! (Reversed Flow)\n\n";
+      *Konsole << "  >> Warnung: u(xa) > 0 ! (Reversed Flow)\n\n";
      }
 
       if ( RBO == OutletBoundary && u[imax] < 0.0 )
      {
-      cout << "  >> Warnung: u(xe) < 0 ! (Reversed Flow)\n\n";
+      *Konsole << "  >> Warnung: u(xe) < 0 ! (Reversed Flow)\n\n";
      }
 
      }
@@ -495,17 +1115,17 @@
       Anfang von RandbedingungAusgeben
       ----------------------------------------------------------------------- */
 
-      void RandbedingungAusgeben(int Nummer,char *Text)
+      void Kontext::RandbedingungAusgeben(int Nummer,char *Text)
      {
       
       switch(Nummer)
      {
-       case  0: cout << " " << Text << "   = 0: Wall-Boundary               \n\n";  break;
-       case  1: cout << " " << Text << "   = 1: Dirichlet-Boundary          \n\n";  break;
-       case  2: cout << " " << Text << "   = 2: Neumann-Boundary            \n\n";  break;
-       case  3: cout << " " << Text << "   = 3: Periodic-Boundary           \n\n";  break;
-       case  4: cout << " " << Text << "   = 4: Dynamic-Boundary            \n\n";  break;
-       case  5: cout << " " << Text << "   = 5: Outlet-Boundary             \n\n";  break;
+       case  0: *Konsole << " " << Text << "   = 0: Wall-Boundary               \n\n";  break;
+       case  1: *Konsole << " " << Text << "   = 1: Dirichlet-Boundary          \n\n";  break;
+       case  2: *Konsole << " " << Text << "   = 2: Neumann-Boundary            \n\n";  break;
+       case  3: *Konsole << " " << Text << "   = 3: Periodic-Boundary           \n\n";  break;
+       case  4: *Konsole << " " << Text << "   = 4: Dynamic-Boundary            \n\n";  break;
+       case  5: *Konsole << " " << Text << "   = 5: Outlet-Boundary             \n\n";  break;
      }
 
      }
@@ -516,29 +1136,55 @@
 
 
 
+   /* -----------------------------------------------------------------------
+      Anfang von LoeserAusgeben
+      ----------------------------------------------------------------------- */
+
+      void Kontext::LoeserAusgeben(int Nummer,char *Text)
+     {
+      
+      switch(Nummer)
+     {
+       case  0: *Konsole << " " << Text << "  = 0: Gauss-Seidel                \n\n";  break;
+       case  1: *Konsole << " " << Text << "  = 1: Thomas-Algorithmus          \n\n";  break;
+       case  2: *Konsole << " " << Text << "  = 2: Thomas-Algorithmus parallel \n\n";  break;
+       case  3: *Konsole << " " << Text << "  = 3: Rot-Schwarz SOR             \n\n";  break;
+       case  4: *Konsole << " " << Text << "  = 4: Mehrgitterverfahren         \n\n";  break;
+       case  5: *Konsole << " " << Text << "  = 5: BiCGSTAB                    \n\n";  break;
+       case  6: *Konsole << " " << Text << "  = 6: GMRES(m)                    \n\n";  break;
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von LoeserAusgeben
+      ----------------------------------------------------------------------- */
+
+
+
    /* -----------------------------------------------------------------------
       Anfang von FunktionsNameAusgeben
       ----------------------------------------------------------------------- */
 
-      void FunktionsNameAusgeben(int Nummer,char *Text)
+      void Kontext::FunktionsNameAusgeben(int Nummer,char *Text)
      {
       
       switch(Nummer)
      {
-       case  0: cout << " " << Text << "   =  0: Konstantefunktion           \n\n";  break;
-       case  1: cout << " " << Text << "   =  1: Lineare Funktion            \n\n";  break;
-       case  2: cout << " " << Text << "   =  2: Parabelfunktion             \n\n";  break;
-       case  3: cout << " " << Text << "   =  3: Rechteckfunktion            \n\n";  break;
-       case  4: cout << " " << Text << "   =  4: Dreieckfunktion             \n\n";  break;
-       case  5: cout << " " << Text << "   =  5: Saegezahnfunktion           \n\n";  break;
-       case  6: cout << " " << Text << "   =  6: Lineare Rampe               \n\n";  break;
-       case  7: cout << " " << Text << "   =  7: Cosinus Rampe               \n\n";  break;
-       case  8: cout << " " << Text << "   =  8: Sinusfunktion               \n\n";  break;
-       case  9: cout << " " << Text << "   =  9: Cosinusfunktion             \n\n";  break;
-       case 10: cout << " " << Text << "   = 10: Exponentialfunktion         \n\n";  break;
-       case 11: cout << " " << Text << "   = 11: Gaussfunktion               \n\n";  break;
-       case 12: cout << " " << Text << "   = 12: Diracfunktion               \n\n";  break;
-       case 13: cout << " " << Text << "   = 12: Heavisidefunktion           \n\n";  break;
+       case  0: *Konsole << " " << Text << "   =  0: Konstantefunktion           \n\n";  break;
+       case  1: *Konsole << " " << Text << "   =  1: Lineare Funktion            \n\n";  break;
+       case  2: *Konsole << " " << Text << "   =  2: Parabelfunktion             \n\n";  break;
+       case  3: *Konsole << " " << Text << "   =  3: Rechteckfunktion            \n\n";  break;
+       case  4: *Konsole << " " << Text << "   =  4: Dreieckfunktion             \n\n";  break;
+       case  5: *Konsole << " " << Text << "   =  5: Saegezahnfunktion           \n\n";  break;
+       case  6: *Konsole << " " << Text << "   =  6: Lineare Rampe               \n\n";  break;
+       case  7: *Konsole << " " << Text << "   =  7: Cosinus Rampe               \n\n";  break;
+       case  8: *Konsole << " " << Text << "   =  8: Sinusfunktion               \n\n";  break;
+       case  9: *Konsole << " " << Text << "   =  9: Cosinusfunktion             \n\n";  break;
+       case 10: *Konsole << " " << Text << "   = 10: Exponentialfunktion         \n\n";  break;
+       case 11: *Konsole << " " << Text << "   = 11: Gaussfunktion               \n\n";  break;
+       case 12: *Konsole << " " << Text << "   = 12: Diracfunktion               \n\n";  break;
+       case 13: *Konsole << " " << Text << "   = 12: Heavisidefunktion           \n\n";  break;
      }
 
      }
@@ -553,7 +1199,7 @@
       Anfang von SimulationVorbereiten
       ----------------------------------------------------------------------- */
 
-      void SimulationVorbereiten(void)
+      void Kontext::SimulationVorbereiten(void)
      {
 
       int i;          // Lokaler Schleifenzähler
@@ -561,6 +1207,41 @@
       imin = 1;       // Erster Zellmittelpunkt
 
       NMAX = 0;       // Zähler auf Null setzen
+      NR   = 0;
+
+      a0   = 1.0;     // Euler-Schritt, bis ZeitverfahrenWaehlen anderes setzt
+      bA   = 1.0;
+      bB   = 0.0;
+      KG   = 0.0;
+      KE   = 0.0;
+
+      VG   = 0;       // Koeffizienten und Zerlegung als ungültig markieren
+      VF   =-1;
+      nA   = 0;       // Noch keine alten Zeitebenen (SK = 3, PR > 0)
+      dtV  = 0.0;     // und keine Schrittweiten dazu (AZ = 2: aus dem Checkpoint)
+      dtVV = 0.0;
+
+      if ( LS == ThomasSolver || LS == ParallelSolver ) PR = NoPredictor;  // Direkt, ohne Startwert
+
+      if ( ZV == SemiLagrangeScheme ) { ZA = FixedTimeStep; PR = NoPredictor; }  // Ohne Zeitfehler und Löser
+
+      if ( PZ > 0 && ( ZA != FixedTimeStep || ZV != ImplicitEuler || TV != NoLimiter || EM + NS > 0 ) )
+     {
+      *Konsole << "\n >> Warnung: Parareal nur mit ZA = 0, ZV = 0, TV = 0 und ohne Zusatzfelder, seriell weiter !\n\n";
+      PZ = 0;
+     }
+
+      if ( PZ > 0 )  // Parareal: gleich viele Zeitschritte je Zeitscheibe
+     {
+      if ( (unsigned long)PZ > nmax ) PZ = nmax;
+      while ( PZ > 0 && nmax % PZ != 0 ) PZ--;
+      if ( PI < 1 ) PI = 1;
+      if ( PG < 1 ) PG = 1;
+      PR = NoPredictor;
+     }
+
+      nF   = EM + NS; // Anzahl der Zusatzfelder
+      nG   = 0;       // Feldgruppen werden in FeldgruppenVorbereiten angelegt
 
       ifstream fin;   // Objekt für Dateieingabe
       ofstream fout;  // Objekt für Dateiausgabe
@@ -569,19 +1250,81 @@
 
    /* ----------------------------------------------------------------------- */
 
-   /* Speicher reservieren */
+   /* Speicher reservieren: alle Felder mit den Indizes 0..imax+1 liegen
+      hintereinander in einem auf 64 Byte ausgerichteten Block. Jedes Feld
+      ist auf ein Vielfaches von 8 doubles aufgefüllt und beginnt damit
+      auf einer Cache-Zeile. Reihenfolge nach gemeinsamer Verwendung:
+      Gitter und u für die Koeffizienten, dann Matrix und Felder für
+      Gauß-Seidel, zuletzt die Zerlegungen. */
+
+      LA    = ( imax + 2 + 7 ) / 8 * 8;
+      Arena = (double*) aligned_alloc( 64, 23*LA*sizeof(double) );
+
+      x    = Arena      ;
+     dx    = x    + LA  ;
+      dtdx = dx   + LA  ;
+      u    = dtdx + LA  ;
+
+      aW   = u    + LA  ;
+      aP   = aW   + LA  ;
+      aE   = aP   + LA  ;
+      raP  = aE   + LA  ;
+      rho  = raP  + LA  ;
+      f    = rho  + LA  ;
+
+      cT   = f    + LA  ;
+      rP   = cT   + LA  ;
+      zT   = rP   + LA  ;
+
+      rB   = zT   + LA  ;  // Partitionierter Löser
+      cB   = rB   + LA  ;
+      vS   = cB   + LA  ;
+      wS   = vS   + LA  ;
+
+      rhoA = wS   + LA  ;  // Zeitebenen und Prädiktor
+      rhoB = rhoA + LA  ;
+      rhoC = rhoB + LA  ;
+      fS   = rhoC + LA  ;
+
+      rhoR = fS   + LA  ;  // Deferred Correction
+      fK   = rhoR + LA  ;
+
+      nD  = ( imax + BD - 1 ) / BD;
+      DB  = new double[3*nD];
+
+      if ( ZV == SemiLagrangeScheme )  // Abfahrtspunkte der Charakteristiken
+     {
+      dZ  = new int   [imax+2];
+      dK  = new int   [imax+2];
+      dA  = new double[imax+2];
+      uN  = new double[imax+2];
+      xF  = new double[imax+2];
+     }
+
+   /* Blockeinteilung für den partitionierten Löser: jeder Thread erhält
+      einen zusammenhängenden Block mit mindestens zwei Zellen */
+
+      if ( NT < 1 ) NT = 1;
+
+      nB = NT;
+      if ( nB > imax/2 ) nB = imax/2;
+      if ( nB < 1      ) nB = 1;
 
-      x   = new double[imax+2];
-     dx   = new double[imax+2];
+      nR = nB - 1;                          // Schnittstellen zwischen den Blöcken
+      if ( RBW == PeriodicBoundary || RBO == PeriodicBoundary ) nR = nB;  // ... und über den Rand
 
-      u   = new double[imax+2];
-      rho = new double[imax+2];
+      iA  = new int[nB];
+      iE  = new int[nB];
 
-      f   = new double[imax+2];
+      for (i=0;i<nB;i++)
+     {
+      iA[i] = imin + ( i   *imax)/nB;
+      iE[i] = imin + ((i+1)*imax)/nB - 1;
+     }
 
-      aW  = new double[imax];
-      aP  = new double[imax];
-      aE  = new double[imax];
+      AR  = new double[nR*nR+1];
+      bR  = new double[nR+1];
+      pR  = new int   [nR+1];
 
    /* ----------------------------------------------------------------------- */
 
@@ -595,11 +1338,56 @@
 
    /* Diskretisierungsschema */
 
-      if (RBW == PeriodicBoundary  ) { ImpliziterZeitschritt = ImpliziterZeitschrittPBC;
-                                       HilfsfelderBerechnen  = HilfsfelderBerechnenPBC ; }
+      if (RBW == PeriodicBoundary  ) { HilfsfelderBerechnen  = &Kontext::HilfsfelderBerechnenPBC ;
+                                       Faktorisieren         = &Kontext::FaktorisierenPBC        ; }
+
+      if (RBW != PeriodicBoundary  ) { HilfsfelderBerechnen  = &Kontext::HilfsfelderBerechnenSTD ;
+                                       Faktorisieren         = &Kontext::FaktorisierenSTD        ; }
+
+   /* Gauß-Seidel: Kernel für das Paar (RBW,RBO) einmalig auswählen */
+
+      ImpliziterZeitschritt = ZeitschrittGS[RBW][RBO];
+
+   /* Mit WF > 1 laufen je WF Iterationen gemeinsam als Wellenfront durch
+      das Gitter. Bei PBC hängt jede Iteration von f[imax] der vorherigen
+      ab, dort bleibt es bei der einfachen Iteration. */
+
+      if ( WF < 1 ) WF = 1;
+
+      DW = new double[WF];
+
+      if ( WF > 1 && RBW != PeriodicBoundary ) ImpliziterZeitschritt = ZeitschrittWF[RBW][RBO];
+
+   /* TVD-Begrenzer für die Korrektur der Massenströme (TV > 0) */
+
+      if ( DK < 1 ) DK = 1;
+
+      if ( TV == MinmodLimiter   ) Begrenzer = &Kontext::Minmod  ;
+      if ( TV == VanLeerLimiter  ) Begrenzer = &Kontext::VanLeer ;
+      if ( TV == SuperbeeLimiter ) Begrenzer = &Kontext::Superbee;
 
-      if (RBW != PeriodicBoundary  ) { ImpliziterZeitschritt = ImpliziterZeitschrittSTD;
-                                       HilfsfelderBerechnen  = HilfsfelderBerechnenSTD ; }
+   /* Direkter Löser */
+
+      if (RBW == PeriodicBoundary && LS == ThomasSolver ) ImpliziterZeitschritt = &Kontext::ImpliziterZeitschrittZYK ;
+      if (RBW != PeriodicBoundary && LS == ThomasSolver ) ImpliziterZeitschritt = &Kontext::ImpliziterZeitschrittTDMA;
+
+      if ( LS == ParallelSolver   ) ImpliziterZeitschritt = &Kontext::ImpliziterZeitschrittPAR;
+      if ( LS == RedBlackSolver   ) ImpliziterZeitschritt = &Kontext::ImpliziterZeitschrittRB ;
+
+      if ( LS == MultigridSolver  ) { MehrgitterAnlegen();
+                                      ImpliziterZeitschritt = &Kontext::ImpliziterZeitschrittMG ; }
+
+   /* Krylov-Löser: Verfahren und Vorkonditionierer getrennt wählbar */
+
+      if ( LS == BiCGStabSolver || LS == GMRESSolver )
+     {
+      KrylovAnlegen();
+      ImpliziterZeitschritt = &Kontext::ImpliziterZeitschrittKRY;
+      KrylovLoeser          = ( LS == GMRESSolver ) ? &Kontext::KrylovGMRES : &Kontext::KrylovBiCGSTAB;
+      Vorkonditionieren     = &Kontext::VorkonditionierenOhne;
+      if ( PK == JacobiPreconditioner ) Vorkonditionieren = &Kontext::VorkonditionierenJAC;
+      if ( PK == ILUPreconditioner    ) Vorkonditionieren = &Kontext::VorkonditionierenILU;
+     }
 
    /* ----------------------------------------------------------------------- */
 
@@ -614,41 +1402,63 @@
 
    /* Externes Gitter einlesen */
 
-      if(mesh==1)
+      if(mesh==1 && GitterDaten == NULL)
      {
       fin.open("mesh.dat");     // Zellmittelpunkte und Gitterabstände
       for (i=imin-1;i<=imax+1;i++) { fin >> x[i]; fin >> dx[i]; }
       fin.close();
      }
 
+      if(mesh==1 && GitterDaten != NULL)  // Von StudieDurchfuehren einmal gelesen
+     {
+      if ( nGD < 2*(imax+2) )
+     {
+      *Konsole << "\n >> Fehler: \"mesh.dat\" enthält zu wenige Zellen !\n\n";
+      abort();
+     }
+      for (i=imin-1;i<=imax+1;i++) { x[i] = GitterDaten[2*i]; dx[i] = GitterDaten[2*i+1]; }
+     }
+
    /* ----------------------------------------------------------------------- */
 
-      N  = 1 + nmax/1000;
+      N  = 1 + nmax/1000;      // Ausgabeintervall
+      if ( NA > 0 ) N = NA;
 
       Pi = 2.0*acos(0.0);
 
    /* Diverse Zeitpunkte berechnen */
 
+      n0 = 0;
+
       if (AZ==0)          // Mit Anfangszustand starten
      {
       t0 = ta;
      }
-      else                // Simulation fortsetzen
+
+      if (AZ==1)          // Simulation fortsetzen
      {
-      fin.open("te.out");
+      fin.open(Pfad + "te.out");
       fin >> t0;          // Globale Anfangszeit t0 einlesen
       fin >> ta;          // Lokale  Anfangszeit ta einlesen
       fin.close();
      }
 
-      te = ta + nmax*dt;  // Lokalen Endzeitpunkt te berechnen
+      if (AZ==2)          // Simulation am Checkpoint fortsetzen
+     {
+      CheckpointEinlesen();  // t0, ta, n0 und alle Felder
+     }
+
+      te = ta + (n0+nmax)*dt;  // Lokalen Endzeitpunkt te berechnen (auch bei ZA = 1)
 
    /* Diverse Zeitpunkte speichern */
 
-      fout.open("te.out");
+      if ( Dateien )
+     {
+      fout.open(Pfad + "te.out");
       fout << t0 << "\n";
       fout << te << "\n";  // te ist nächstes ta
       fout.close();
+     }
 
    /* ----------------------------------------------------------------------- */
 
@@ -666,19 +1476,22 @@
 
       for (i=imin-1;i<=imax+1;i++)  // Alle Zellmittelpunkte
      {
-        u[i] = u4*U0( ( x[i]-u1 )/u3 ) + u2;
-      rho[i] = r4*R0( ( x[i]-r1 )/r3 ) + r2;      
+        u[i] = u4*(this->*U0)( ( x[i]-u1 )/u3 ) + u2;
+      rho[i] = r4*(this->*R0)( ( x[i]-r1 )/r3 ) + r2;      
      }
 
    /* Anfangszustand für Grafik ohne Ränder speichern */
 
-      fout.open("u.out");
+      if ( Dateien )
+     {
+      fout.open(Pfad + "u.out");
       for (i=imin;i<=imax;i++) fout << x[i] << " " << u[i]   << "\n";
       fout.close();
 
-      fout.open("rho0.out");
+      fout.open(Pfad + "rho0.out");
       for (i=imin;i<=imax;i++) fout << x[i] << " " << rho[i] << "\n";
       fout.close();
+     }
 
    /* Optional Randzellen anpassen */
 
@@ -687,8 +1500,8 @@
       rho[imin-1] += r5;
       rho[imax-1] += r6;
 
-      if ( RBW == DynamicBoundary ) rho[imin-1] = w4*W0( ( ta - w1 )/w3 ) + w2;
-      if ( RBO == DynamicBoundary ) rho[imax+1] = o4*O0( ( te - r1 )/o3 ) + o2;
+      if ( RBW == DynamicBoundary ) rho[imin-1] = w4*(this->*W0)( ( ta - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) rho[imax+1] = o4*(this->*O0)( ( te - r1 )/o3 ) + o2;
 
       if ( RBW == PeriodicBoundary )
      {
@@ -708,17 +1521,17 @@
       if (AZ==1)  // Simulation fortsetzen: u und rho einlesen
      {
 
-      fin.open("u.out");
+      fin.open(Pfad + "u.out");
       for(i=imin;i<=imax;i++) { fin >> u[i]; fin >> u[i];}      // Ortskoordinate überlesen
       fin.close();
 
-      fin.open("rho.out");
+      fin.open(Pfad + "rho.out");
       for(i=imin;i<=imax;i++) { fin >> rho[i]; fin >> rho[i];}   // Ortskoordinate überlesen
       fin.close();
 
    /* Geisterzellen separat einlesen */
 
-      fin.open("Boundary.out");
+      fin.open(Pfad + "Boundary.out");
       fin >>   u[imin-1];
       fin >>   u[imax+1];
       fin >> rho[imin-1];
@@ -731,15 +1544,19 @@
 
    /* Diverse Größen berechnen*/
 
-      MasseBerechnen();
-      EkinBerechnen();
-      ImpulsBerechnen();
-      HilfsfelderBerechnen();
+      DiagnoseBerechnen();
+
+      VG++;                          // Gitter und u sind neu gesetzt
+      KoeffizientenAktualisieren();  // Koeffizienten und Zerlegung berechnen
 
    /* Bei NeumannBoundary die erste Ableitung speichern */
 
-      if ( RBW == NeumannBoundary ) GetGradient( rho, imin, dxrhoW);  // RBW merken
-      if ( RBO == NeumannBoundary ) GetGradient( rho, imax, dxrhoO);  // RBO merken
+      if ( RBW == NeumannBoundary && AZ != 2 ) GetGradient( rho, imin, dxrhoW);  // RBW merken
+      if ( RBO == NeumannBoundary && AZ != 2 ) GetGradient( rho, imax, dxrhoO);  // RBO merken
+
+   /* Ensemble und zusätzliche Skalare */
+
+      if ( nF > 0 ) FeldgruppenVorbereiten();
 
      }
 
@@ -753,7 +1570,7 @@
       Anfang von SimulationDurchfuehren
       ----------------------------------------------------------------------- */
 
-      void SimulationDurchfuehren(void)
+      void Kontext::SimulationDurchfuehren(void)
      {
 
    /* ------------------------------------------------------------------ */
@@ -765,91 +1582,132 @@
       unsigned long n;             // Schleifenzähler
 
       ofstream Mout, Ekin, pxOut;  // Objekte für die Dateiausgabe
+      ofstream MEout, MSout;       // Massen von Ensemble und Skalaren
 
    /* ------------------------------------------------------------------ */
 
-      cout << setiosflags(ios::left);
+      *Konsole << setiosflags(ios::left);
 
       Mout  << setiosflags(ios::scientific) << setprecision(13);
       Ekin  << setiosflags(ios::scientific) << setprecision(13);
       pxOut << setiosflags(ios::scientific) << setprecision(13);
       Dout << setiosflags(ios::scientific) << setprecision(13);
+      MEout << setiosflags(ios::scientific) << setprecision(13);
+      MSout << setiosflags(ios::scientific) << setprecision(13);
 
    /* ------------------------------------------------------------------ */
 
    /* Simulation durchführen */
 
-      if (AZ==1)
+      if (AZ!=0)
      {
 
-       Mout.open("M.out",   ios::app);
-       Ekin.open("Ekin.out",ios::app);
-      pxOut.open("px.out",  ios::app);
-       Dout.open("D.out",ios::app);
+       Mout.open(Pfad + "M.out",   ios::app);
+       Ekin.open(Pfad + "Ekin.out",ios::app);
+      pxOut.open(Pfad + "px.out",  ios::app);
+      if ( DL == StepLog ) Dout.open(Pfad + "D.out",ios::app);
+      if ( EM > 0 ) MEout.open(Pfad + "ME.out",ios::app);
+      if ( NS > 0 ) MSout.open(Pfad + "MS.out",ios::app);
 
      }
       else
      {
 
-       Mout.open("M.out"   );
-       Ekin.open("Ekin.out");
-      pxOut.open("px.out"  );
-       Dout.open("D.out");
+       Mout.open(Pfad + "M.out"   );
+       Ekin.open(Pfad + "Ekin.out");
+      pxOut.open(Pfad + "px.out"  );
+      if ( DL == StepLog ) Dout.open(Pfad + "D.out");
 
        Mout << ta << " " << M  << "\n";
        Ekin << ta << " " << Ek << "\n";
       pxOut << ta << " " << px << "\n";
 
+      if ( EM > 0 ) MEout.open(Pfad + "ME.out");
+      if ( NS > 0 ) MSout.open(Pfad + "MS.out");
+      if ( nF > 0 ) FeldgruppenMasseSchreiben(MEout,MSout,ta);
+
      }
 
-      cout << " Status: 0%\r" << flush;
+      if ( DL == FullLog ) DefektProtokollStarten();
+      if ( CP >  0       ) CheckpointStarten();
+
+      *Konsole << " Status: 0%\r" << flush;
+
+   /* Zeitschleife: bei ZA = 0 genau nmax Schritte, bei ZA = 1 bis te */
 
-   /* Zeitschleife */
+      ZeitschleifeStarten();
 
-      for (n=1;n<=nmax;n++)
+      for (n=1; ( ZA == FixedTimeStep ) ? n <= nmax : tS < te ; n++)
      {
 
-      t = ta + n*dt;
+      Zeitschritt(n);
 
-   /* Euler-Zeitschritt */
+      if ( DL == StepLog && PR >  0 ) Dout << n0+n << " " << KS << " " << DS << " " << KP << "\n";
+      if ( DL == StepLog && PR == 0 ) Dout << n0+n << " " << KS << " " << DS << "\n";
+      if ( DL == FullLog ) DefektSpeichern( -(double)(n0+n) );  // Trenner: -n nach Zeitschritt n
 
-      ImpliziterZeitschritt();
+      if ( nF > 0 ) FeldgruppenZeitschritt();
+
+      if ( CP > 0 && n%CP == 0 ) CheckpointSchreiben(n0+n);
 
    /* ----------------------------------------------------------------------- */
 
       if(n%N==0)
      {
-      MasseBerechnen();
-      EkinBerechnen();
-      ImpulsBerechnen();
+      DiagnoseBerechnen();
        Mout << t << " " << M  << "\n";
        Ekin << t << " " << Ek << "\n";
       pxOut << t << " " << px << "\n";
-      cout << " Status: " << n*100/nmax << "%\r" << flush;
+      if ( nF > 0 ) FeldgruppenMasseSchreiben(MEout,MSout,t);
+      if ( ZA == FixedTimeStep ) *Konsole << " Status: " << n*100/nmax << "%\r" << flush;
+      else                       *Konsole << " Status: " << (int)( 100.0*( t - ta )/( te - ta ) ) << "%\r" << flush;
      }
 
      }  // Ende Zeitschleife
 
+      n = n - 1;  // Anzahl der ausgeführten Zeitschritte (ZA = 0: nmax)
+
    /* ----------------------------------------------------------------------- */
 
-      if( nmax%N != 0 || nmax == 0)
+      if( n%N != 0 || n == 0)
      {
-      MasseBerechnen();
-      EkinBerechnen();
-      ImpulsBerechnen();
+      DiagnoseBerechnen();
        Mout << te << " " << M  << "\n";
        Ekin << te << " " << Ek                << "\n";
       pxOut << te << " " << px << "\n";
+      if ( nF > 0 ) FeldgruppenMasseSchreiben(MEout,MSout,te);
      }
 
        Mout.close();
        Ekin.close();
       pxOut.close();
        Dout.close();
+      MEout.close();
+
+      if ( DL == FullLog ) DefektProtokollBeenden();
+
+      if ( CP > 0 )
+     {
+      if ( n%CP != 0 ) CheckpointSchreiben(n0+n);  // Endzustand sichern
+      CheckpointBeenden();
+     }
+      MSout.close();
+
+      *Konsole << " Status: 100%\n\n" << flush;
+
+      *Konsole << " IMAX " << NMAX << " mal erreicht!\n\n";
 
-      cout << " Status: 100%\n\n" << flush;
+      if ( n > 0 && ZA == AdaptiveTimeStep )
+      *Konsole << " Zeitschritte: " << n << " (" << NR << " verworfen), dt von " << dtK << " bis " << dtG << "\n\n";
 
-      cout << " IMAX " << NMAX << " mal erreicht!\n\n";
+      if ( n > 0 && KG > 0.0 )
+      *Konsole << " Innere Iterationen: " << KG << " (" << KG/n << " je Zeitschritt)\n\n";
+
+      if ( n > 0 && PR > 0 )
+      *Konsole << " Eingespart (geschätzt): " << KE << " (" << KE/n << " je Zeitschritt)\n\n";
+
+      if ( LS == RedBlackSolver )
+      *Konsole << " Relaxationsfaktor:  " << wR << " (Jacobi-Spektralradius " << rJ << ")\n\n";
 
      }
 
@@ -860,398 +1718,5039 @@
 
 
    /* -----------------------------------------------------------------------
-      Anfang von ErgebnisseSpeichern
+      Anfang von ZeitschleifeStarten
       ----------------------------------------------------------------------- */
 
-      void ErgebnisseSpeichern(void)
+      void Kontext::ZeitschleifeStarten(void)
      {
 
-      int i;  // Schleifenzähler
-
-      ofstream fout;
-
-      fout << setiosflags(ios::scientific) << setprecision(13);
-
-      fout.open("C.out");       // Convective Courant Number
-      for (i=imin;i<=imax;i++) fout << x[i] << " " << fabs(u[i])*dt/dx[i] << "\n";
-      fout.close();
-
-      fout.open("rho.out");
-      for (i=imin;i<=imax;i++) fout << x[i] << " " << rho[i] << "\n";
-      fout.close();
-
-      fout.open("jm.out");
-      for (i=imin;i<=imax;i++) fout << x[i] << " " << rho[i]*u[i] << "\n";
-      fout.close();
-
-   /* Geisterzellen separat speichern */
+      tS  = ta + n0*dt;
+      dtN = dt; dtK = te - ta; dtG = 0.0;
 
-      fout.open("Boundary.out");
-      fout <<   u[imin-1] << "\n";
-      fout <<   u[imax+1] << "\n";
-      fout << rho[imin-1] << "\n";
-      fout << rho[imax+1] << "\n";
-      fout.close();
+      nK  = 0;
 
      }
 
    /* -----------------------------------------------------------------------
-      Ende von ErgebnisseSpeichern
+      Ende von ZeitschleifeStarten
       ----------------------------------------------------------------------- */
 
 
 
    /* -----------------------------------------------------------------------
-      Anfang von ErgebnisseDarstellen
+      Anfang von BibliothekVorbereiten
       ----------------------------------------------------------------------- */
 
-      void ErgebnisseDarstellen(void)
+      void Kontext::BibliothekVorbereiten(void)
      {
 
-      if (ED==1) system("showresults");
+   /* SimulationVorbereiten für Läufe ohne Dateien, die SchritteRechnen
+      schrittweise vorantreibt (Bibliothek und Dienst) */
+
+      PZ = 0;  // Parareal braucht alle Zeitscheiben auf einmal
+      DL = 0;  // Kein Defektprotokoll
+      CP = 0;  // Keine Checkpoints
+
+      Dateien = false;
+
+      SimulationVorbereiten();
+      ZeitschleifeStarten();
 
      }
 
    /* -----------------------------------------------------------------------
-      Ende von ErgebnisseDarstellen
+      Ende von BibliothekVorbereiten
       ----------------------------------------------------------------------- */
 
-   
-   
+
+
    /* -----------------------------------------------------------------------
-      Anfang von ProgrammBeenden
+      Anfang von Zeitschritt
       ----------------------------------------------------------------------- */
 
-      void ProgrammBeenden(void)
+      void Kontext::Zeitschritt(unsigned long n)  // Zeitschritt n nach n0, ohne Ausgabe
      {
 
-      cout << " Programm beendet.\n\n";
+      if ( ZA == FixedTimeStep ) t = ta + (n0+n)*dt;
 
-     }
+      if ( SK == AdaptiveStop || PR > 0 || ZA == AdaptiveTimeStep || ZV != ImplicitEuler || TV != NoLimiter ) ZeitebenenSpeichern();
 
-   /* -----------------------------------------------------------------------
-      Ende von ProgrammBeenden
-      ----------------------------------------------------------------------- */
+   /* Euler-Zeitschritt, bei ZA = 1 mit kleinerem dt wiederholt, solange
+      der geschätzte Zeitfehler zu groß ist */
 
+      do
+     {
 
+      if ( ZA == AdaptiveTimeStep ) ZeitschrittWaehlen();  // Setzt dt und t
 
-   /* ------------------------------------------------------------------
-      Anfang von VolumenIntegration
-      ------------------------------------------------------------------ */
+      if ( ZV != ImplicitEuler ) ZeitverfahrenWaehlen();   // Setzt a0, bA und bB
 
-      double VolumenIntegration(double *m)  // Rechteckregel (zellzentriert)
+      if ( PR > 0 || ZA == AdaptiveTimeStep ) ExtrapolationWaehlen();  // Setzt wL, lA, lB und lC
+
+      KoeffizientenAktualisieren();  // Nur bei geändertem a0*dt, Gitter oder u
+
+      KS = 0; DS = 0.0;              // Direkte Löser iterieren nicht
+
+      AbbruchschrankeBerechnen();
+
+      if ( PR > 0 ) VorhersageBerechnen();
+
+      if ( ZV != ImplicitEuler ) RechteSeiteBerechnen();  // Überschreibt rho mit der rechten Seite
+
+      if      ( ZV == SemiLagrangeScheme ) SemiLagrangeZeitschritt();
+      else if ( TV == NoLimiter          ) (this->*ImpliziterZeitschritt)();
+      else                                 KorrekturZeitschritt();  // DK Lösungen mit korrigierter rechter Seite
+
+      KG += KS;
+
+     }
+      while ( ZA == AdaptiveTimeStep && !ZeitschrittAnnehmen() );
+
+      if ( ZA == FixedTimeStep ) { dtVV = dtV; dtV = dt; }  // Bei ZA = 1 in ZeitschrittAnnehmen
+
+      if ( PR > 0 ) EinsparungSchaetzen();  // Setzt KP
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von Zeitschritt
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von SchritteRechnen
+      ----------------------------------------------------------------------- */
+
+      unsigned long Kontext::SchritteRechnen(unsigned long m)
+     {
+
+   /* Für die Bibliothek: m weitere Zeitschritte ohne Dateiausgabe, bei
+      ZA = 1 höchstens bis te. Gitter und u dürfen sich zwischen zwei
+      Aufrufen ändern (dann VG erhöhen), rho samt Geisterzellen auch. */
+
+      unsigned long j;  // Schleifenzähler
+
+      for (j=0;j<m;j++)
+     {
+      if ( ZA == AdaptiveTimeStep && tS >= te ) break;
+
+      nK++;
+
+      Zeitschritt(nK);
+
+      if ( nF > 0 ) FeldgruppenZeitschritt();
+     }
+
+      return j;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von SchritteRechnen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von PararealDurchfuehren
+      ----------------------------------------------------------------------- */
+
+      void Kontext::PararealDurchfuehren(void)
+     {
+
+   /* Parareal ersetzt die serielle Zeitschleife durch PZ Zeitscheiben mit
+      je m = nmax/PZ Zeitschritten. Der grobe Propagator G rechnet eine
+      Zeitscheibe mit PG Euler-Schritten der Länge m*dt/PG, der feine F mit
+      den m Euler-Schritten der seriellen Rechnung. In der Iteration k
+      laufen die feinen Propagatoren aller noch offenen Zeitscheiben
+      gleichzeitig, danach folgt seriell die Korrektur
+
+           U[j+1] = G(U[j]) + F(U[j] der Vorgänger-Iteration) - G(U[j] der Vorgänger-Iteration)
+
+      Nach k Iterationen sind die ersten k Zeitscheiben exakt, spätestens
+      nach PZ Iterationen also alle. Beide Propagatoren lösen direkt mit
+      der gespeicherten LR-Zerlegung (Thomas, zyklisch bei PBC). */
+
+      int i, j, k ;                // Schleifenzähler
+
+      unsigned long m;             // Feine Zeitschritte je Zeitscheibe
+
+      double *U;                   // rho an den Grenzen der Zeitscheiben
+      double *F;                   // Feine Lösung je Zeitscheibe
+      double *G;                   // Grobe Lösung je Zeitscheibe
+      double *g;                   // Neue grobe Lösung
+      double *S = NULL;            // Serielle Lösung an den Grenzen (PV = 1)
+      double *h;                   // Hilfszeiger
+
+      double e, r, s, sS = 1.0, d; // Änderung, Wert, max|U|, max|S|, Abweichung von S
+      double tP, tS = 0.0;         // Laufzeit Parareal und seriell
+
+      ofstream Mout, Ekin, pxOut;  // Objekte für die Dateiausgabe
+
+      chrono::steady_clock::time_point T;  // Startzeit der Zeitmessung
+
+      m = nmax/PZ;
+
+   /* ------------------------------------------------------------------ */
+
+   /* Feiner Propagator: Zerlegung des Hauptfeldes. Grober Propagator:
+      eigene Koeffizienten und Zerlegung, dazu werden die Felder wie in
+      FeldgruppenKoeffizienten vorübergehend vertauscht. */
+
+      (this->*Faktorisieren)();
+
+      PP[0].dt = dt;
+      PP[0].aW = aW; PP[0].aP = aP; PP[0].aE = aE;
+      PP[0].rP = rP; PP[0].cT = cT; PP[0].zT = zT;
+      PP[0].zS = zS; PP[0].vZ = vZ;
+
+      PP[1].dt = m*dt/PG;
+      PP[1].aW = new double[LA]; PP[1].aP = new double[LA]; PP[1].aE = new double[LA];
+      PP[1].rP = new double[LA]; PP[1].cT = new double[LA]; PP[1].zT = new double[LA];
+
+      swap(dt,PP[1].dt);
+      swap(aW,PP[1].aW); swap(aP,PP[1].aP); swap(aE,PP[1].aE);
+      swap(rP,PP[1].rP); swap(cT,PP[1].cT); swap(zT,PP[1].zT);
+
+      (this->*HilfsfelderBerechnen)(); (this->*Faktorisieren)();
+
+      swap(dt,PP[1].dt);
+      swap(aW,PP[1].aW); swap(aP,PP[1].aP); swap(aE,PP[1].aE);
+      swap(rP,PP[1].rP); swap(cT,PP[1].cT); swap(zT,PP[1].zT);
+
+      PP[1].zS = zS; PP[1].vZ = vZ;
+            zS = PP[0].zS; vZ = PP[0].vZ;
+
+   /* ------------------------------------------------------------------ */
+
+      U = new double[(PZ+1)*LA];
+      F = new double[ PZ   *LA];
+      G = new double[ PZ   *LA];
+      g = new double[       LA];
+
+      *Konsole << setiosflags(ios::left);
+
+   /* Serielle Referenz mit demselben feinen Propagator */
+
+      if ( PV == 1 )
+     {
+      S = new double[(PZ+1)*LA];
+      for (i=imin-1;i<=imax+1;i++) S[i] = rho[i];
+
+      T = chrono::steady_clock::now();
+      for (j=0;j<PZ;j++)
+     {
+      for (i=imin-1;i<=imax+1;i++) S[(j+1)*LA+i] = S[j*LA+i];
+      PararealPropagieren(0, S + (j+1)*LA, ta + (n0+j*m)*dt, m);
+     }
+      tS = chrono::duration<double>( chrono::steady_clock::now() - T ).count();
+
+      sS = 0.0;
+      for (j=1;j<=PZ;j++) for (i=imin;i<=imax;i++) sS = max( sS, fabs(S[j*LA+i]) );
+     }
+
+   /* Startwerte aus einem groben Durchlauf */
+
+      T = chrono::steady_clock::now();
+
+      for (i=imin-1;i<=imax+1;i++) U[i] = rho[i];
+
+      for (j=0;j<PZ;j++)
+     {
+      for (i=imin-1;i<=imax+1;i++) G[j*LA+i] = U[j*LA+i];
+      PararealPropagieren(1, G + j*LA, ta + (n0+j*m)*dt, PG);
+      for (i=imin-1;i<=imax+1;i++) U[(j+1)*LA+i] = G[j*LA+i];
+     }
+
+   /* Parareal-Iterationen */
+
+      for (k=1;k<=PI;k++)
+     {
+
+      #pragma omp parallel for num_threads(NT) schedule(dynamic) private(i)
+      for (j=k-1;j<PZ;j++)
+     {
+      for (i=imin-1;i<=imax+1;i++) F[j*LA+i] = U[j*LA+i];
+      PararealPropagieren(0, F + j*LA, ta + (n0+j*m)*dt, m);
+     }
+
+      e = 0.0; s = 0.0;
+
+      for (j=k-1;j<PZ;j++)
+     {
+
+      if ( j == k-1 ) for (i=imin-1;i<=imax+1;i++) g[i] = G[j*LA+i];  // U[j] unverändert
+      else
+     {
+      for (i=imin-1;i<=imax+1;i++) g[i] = U[j*LA+i];
+      PararealPropagieren(1, g, ta + (n0+j*m)*dt, PG);
+     }
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      r = g[i] + F[j*LA+i] - G[j*LA+i];
+      if ( i >= imin && i <= imax ) { e = max( e, fabs( r - U[(j+1)*LA+i] ) ); s = max( s, fabs(r) ); }
+      U[(j+1)*LA+i] = r;
+      G[ j   *LA+i] = g[i];
+     }
+
+     }
+
+      *Konsole << " Parareal-Iteration " << setw(4) << k << " Änderung: " << setw(15) << e/s;
+
+      if ( PV == 1 )
+     {
+      d = 0.0;
+      for (j=1;j<=PZ;j++) for (i=imin;i<=imax;i++) d = max( d, fabs( U[j*LA+i] - S[j*LA+i] ) );
+      *Konsole << " Abweichung von seriell: " << d/sS;
+     }
+
+      *Konsole << "\n" << flush;
+
+      if ( e <= PT*s || k == PZ ) break;
+
+     }
+
+      tP = chrono::duration<double>( chrono::steady_clock::now() - T ).count();
+
+      if ( k > PI ) k = PI;
+
+   /* ------------------------------------------------------------------ */
+
+   /* Masse, Energie und Impuls an den Grenzen der Zeitscheiben */
+
+      Mout  << setiosflags(ios::scientific) << setprecision(13);
+      Ekin  << setiosflags(ios::scientific) << setprecision(13);
+      pxOut << setiosflags(ios::scientific) << setprecision(13);
+
+      if (AZ!=0)
+     {
+       Mout.open(Pfad + "M.out",   ios::app);
+       Ekin.open(Pfad + "Ekin.out",ios::app);
+      pxOut.open(Pfad + "px.out",  ios::app);
+     }
+      else
+     {
+       Mout.open(Pfad + "M.out"   );
+       Ekin.open(Pfad + "Ekin.out");
+      pxOut.open(Pfad + "px.out"  );
+
+       Mout << ta << " " << M  << "\n";
+       Ekin << ta << " " << Ek << "\n";
+      pxOut << ta << " " << px << "\n";
+     }
+
+      h = rho;
+
+      for (j=1;j<=PZ;j++)
+     {
+      rho = U + j*LA;
+      DiagnoseBerechnen();
+      t   = ( j == PZ ) ? te : ta + (n0+j*m)*dt;
+       Mout << t << " " << M  << "\n";
+       Ekin << t << " " << Ek << "\n";
+      pxOut << t << " " << px << "\n";
+     }
+
+      rho = h;
+
+       Mout.close();
+       Ekin.close();
+      pxOut.close();
+
+      for (i=imin-1;i<=imax+1;i++) rho[i] = U[PZ*LA+i];
+
+      if ( CP > 0 )  // Nur der Endzustand
+     {
+      CheckpointStarten();
+      CheckpointSchreiben(n0+nmax);
+      CheckpointBeenden();
+     }
+
+   /* ------------------------------------------------------------------ */
+
+      *Konsole << "\n Parareal: " << PZ << " Zeitscheiben, " << k << " Iterationen, "
+           << tP << " s (höchstens " << (double)PZ/k << "-fach schneller als seriell)\n\n";
+
+      if ( PV == 1 )
+      *Konsole << " Seriell:  " << tS << " s, Beschleunigung " << tS/tP << "\n\n";
+
+      delete[] U; delete[] F; delete[] G; delete[] g; delete[] S;
+
+      delete[] PP[1].aW; delete[] PP[1].aP; delete[] PP[1].aE;
+      delete[] PP[1].rP; delete[] PP[1].cT; delete[] PP[1].zT;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von PararealDurchfuehren
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von PararealPropagieren
+      ----------------------------------------------------------------------- */
+
+      void Kontext::PararealPropagieren(int l, double *r, double tA, unsigned long m)
+     {
+
+   /* m Euler-Schritte des Propagators PP[l] ab der Zeit tA auf dem Feld r
+      (mit Geisterzellen). Wie ImpliziterZeitschrittTDMA bzw. ZYK, aber
+      ohne globale Hilfsfelder und damit in mehreren Threads zugleich
+      aufrufbar. Vorwärts- und Rückwärtseinsetzen arbeiten direkt in r. */
+
+      int i ;                      // Schleifenzähler
+
+      unsigned long n;             // Zeitschritt
+
+      double tn, bW, bO, s;        // Zeit, Beiträge der Geisterzellen, Korrektur
+
+      Propagator *P = PP + l;      // Zerlegung
+
+      for (n=1;n<=m;n++)
+     {
+
+      tn = tA + n*P->dt;
+
+      if ( RBW == DynamicBoundary ) r[imin-1] = w4*(this->*W0)( ( tn - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) r[imax+1] = o4*(this->*O0)( ( tn - o1 )/o3 ) + o2;
+
+      if ( RBW == PeriodicBoundary )
+     {
+
+      r[imin] *= P->rP[imin];
+
+      for (i=imin+1;i<=imax;i++) r[i] = ( r[i] - P->aW[i]*r[i-1] ) * P->rP[i];
+
+      for (i=imax-1;i>=imin;i--) r[i] -= P->cT[i]*r[i+1];
+
+      s = ( r[imin] + P->vZ*r[imax] ) / P->zS;
+
+      for (i=imin;i<=imax;i++) r[i] -= s*P->zT[i];
+
+      r[imin-1] = r[imax];  // Periodische Geisterzellen
+      r[imax+1] = r[imin];
+
+     }
+      else
+     {
+
+      bW = - P->aW[imin]*r[imin-1];
+      bO = - P->aE[imax]*r[imax+1];
+
+      if ( RBW == NeumannBoundary ) bW =   P->aW[imin]*dxrhoW*( x[imin] - x[imin-1] );
+      if ( RBO == NeumannBoundary ) bO = - P->aE[imax]*dxrhoO*( x[imax+1] - x[imax] );
+
+      r[imin] = ( r[imin] + bW ) * P->rP[imin];
+
+      for (i=imin+1;i<=imax-1;i++) r[i] = ( r[i] - P->aW[i]*r[i-1] ) * P->rP[i];
+
+         i  = imax;
+      r[i] = ( r[i] + bO - P->aW[i]*r[i-1] ) * P->rP[i];
+
+      for (i=imax-1;i>=imin;i--) r[i] -= P->cT[i]*r[i+1];
+
+      if ( RBW == NeumannBoundary ) SetGradient( r, imin, dxrhoW );
+      if ( RBO == NeumannBoundary ) SetGradient( r, imax, dxrhoO );
+
+     }
+
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von PararealPropagieren
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ErgebnisseSpeichern
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ErgebnisseSpeichern(void)
+     {
+
+      int i;  // Schleifenzähler
+
+      ofstream fout;
+
+      fout << setiosflags(ios::scientific) << setprecision(13);
+
+      fout.open(Pfad + "C.out");       // Convective Courant Number
+      for (i=imin;i<=imax;i++) fout << x[i] << " " << fabs(u[i])*dt/dx[i] << "\n";
+      fout.close();
+
+      fout.open(Pfad + "rho.out");
+      for (i=imin;i<=imax;i++) fout << x[i] << " " << rho[i] << "\n";
+      fout.close();
+
+      fout.open(Pfad + "jm.out");
+      for (i=imin;i<=imax;i++) fout << x[i] << " " << rho[i]*u[i] << "\n";
+      fout.close();
+
+   /* Geisterzellen separat speichern */
+
+      fout.open(Pfad + "Boundary.out");
+      fout <<   u[imin-1] << "\n";
+      fout <<   u[imax+1] << "\n";
+      fout << rho[imin-1] << "\n";
+      fout << rho[imax+1] << "\n";
+      fout.close();
+
+      if ( nF > 0 ) FeldgruppenSpeichern();
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ErgebnisseSpeichern
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ErgebnisseDarstellen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ErgebnisseDarstellen(void)
+     {
+
+      if (ED==1) system("showresults");
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ErgebnisseDarstellen
+      ----------------------------------------------------------------------- */
+
+   
+   
+   /* -----------------------------------------------------------------------
+      Anfang von ProgrammBeenden
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ProgrammBeenden(void)
+     {
+
+      *Konsole << " Programm beendet.\n\n";
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ProgrammBeenden
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ~Kontext
+      ----------------------------------------------------------------------- */
+
+      Kontext::~Kontext(void)
+     {
+
+   /* Speicher eines Laufs freigeben. Nicht angelegte Felder sind NULL
+      (Kontext mit new Kontext() angelegt), delete[] NULL ist erlaubt. */
+
+      int l;  // Lokaler Schleifenzähler
+
+      free(Arena);
+
+      delete[] DB; delete[] DW;
+      delete[] dZ; delete[] dK; delete[] dA; delete[] uN; delete[] xF;
+      delete[] iA; delete[] iE; delete[] AR; delete[] bR; delete[] pR;
+
+      delete[] nL; delete[] oL;
+      delete[] gW; delete[] gP; delete[] gE; delete[] gQ;
+      delete[] gU; delete[] gB; delete[] gR; delete[] gA; delete[] gp;
+
+      delete[] kB; delete[] kD; delete[] kL; delete[] kU; delete[] kV; delete[] kH;
+
+      delete[] chkF; delete[] chkG; delete[] chkV;
+
+      for (l=0;l<nG;l++)
+     {
+      delete[] FG[l].rho; delete[] FG[l].p; delete[] FG[l].g; delete[] FG[l].s;
+      delete[] FG[l].rV;  delete[] FG[l].rR;
+      if ( FG[l].aW == aW ) continue;  // Matrix des Hauptfeldes
+      delete[] FG[l].aW; delete[] FG[l].aP; delete[] FG[l].aE;
+      delete[] FG[l].rP; delete[] FG[l].cT; delete[] FG[l].zT;
+      delete[] FG[l].dZ; delete[] FG[l].dK; delete[] FG[l].dA;
+     }
+
+      delete[] FG; delete[] gF; delete[] kF; delete[] mF;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ~Kontext
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von StudieDurchfuehren
+      ----------------------------------------------------------------------- */
+
+      void StudieDurchfuehren(const char *Datei, int nW)
+     {
+
+   /* Jede Zeile des Manifests beschreibt einen Fall:
+
+           <Verzeichnis> <Name>=<Wert> <Name>=<Wert> ...
+
+      Name ist der Kurzname eines Parameters aus input.dat (z.B. dt, LS,
+      RBW), Zeilen mit # sind Kommentare. Alle Fälle laufen in einem
+      Prozess auf nW Arbeitern (0: ein Arbeiter je Prozessorkern), jeder
+      mit eigenem Kontext. input.dat und mesh.dat werden nur einmal
+      gelesen, gleiche Koeffizientensätze nur einmal berechnet. */
+
+      int i;                   // Schleifenzähler
+
+      double w;                // Wert aus mesh.dat
+
+      string Zeile, Name;      // Zeile des Manifests, Verzeichnis
+
+      ifstream fin;            // Eingabeobjekt
+
+      ostringstream Inhalt;    // Inhalt von input.dat
+
+      Studie S;                // Gemeinsame Daten
+
+      thread *A;               // Arbeiter
+
+      chrono::steady_clock::time_point T = chrono::steady_clock::now();
+
+      fin.open(Datei);
+
+      while ( getline(fin,Zeile) )
+     {
+      istringstream z(Zeile);
+      if ( !( z >> Name ) || Name[0] == '#' ) continue;
+      S.Verzeichnis.push_back(Name);
+      getline(z,Zeile);
+      S.Aenderung.push_back(Zeile);
+     }
+
+      fin.close();
+
+      fin.open("input.dat");
+      Inhalt << fin.rdbuf();
+      S.Basis = Inhalt.str();
+      fin.close();
+
+      fin.open("mesh.dat");
+      while ( fin >> w ) S.Gitter.push_back(w);
+      fin.close();
+
+      if ( nW < 1 ) nW = thread::hardware_concurrency();
+      if ( nW > (int)S.Verzeichnis.size() ) nW = S.Verzeichnis.size();
+      if ( nW < 1 ) nW = 1;
+
+      cout << "\n Parameterstudie: " << S.Verzeichnis.size() << " Fälle auf " << nW << " Arbeitern\n\n";
+
+   /* Fälle reihum verteilen, Arbeiter ohne Fälle stehlen später */
+
+      S.nW = nW;
+      S.W  = new Warteschlange[nW];
+
+      for (i=0;i<(int)S.Verzeichnis.size();i++) S.W[i%nW].Fall.push_back(i);
+
+      A = new thread[nW];
+
+      for (i=0;i<nW;i++) A[i] = thread(StudieArbeiter,&S,i);
+      for (i=0;i<nW;i++) A[i].join();
+
+      cout << "\n Parameterstudie beendet: "
+           << chrono::duration<double>( chrono::steady_clock::now() - T ).count() << " s, "
+           << S.Speicher.Satz.size() << " verschiedene Koeffizientensätze\n\n";
+
+      delete[] A;
+      delete[] S.W;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von StudieDurchfuehren
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von StudieArbeiter
+      ----------------------------------------------------------------------- */
+
+      void StudieArbeiter(Studie *S, int w)
+     {
+
+      int f;  // Nummer des Falls
+
+      while ( FallHolen(S,w,f) ) FallRechnen(S,f);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von StudieArbeiter
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FallHolen
+      ----------------------------------------------------------------------- */
+
+      bool FallHolen(Studie *S, int w, int &f)
+     {
+
+   /* Eigene Fälle von vorn, sonst einen Fall von hinten aus der
+      Warteschlange eines anderen Arbeiters stehlen. Neue Fälle entstehen
+      nicht, leere Warteschlangen überall heißt also fertig. */
+
+      int i, j;  // Schleifenzähler, Arbeiter
+
+     {
+      lock_guard<mutex> g(S->W[w].m);
+      if ( !S->W[w].Fall.empty() ) { f = S->W[w].Fall.front(); S->W[w].Fall.pop_front(); return true; }
+     }
+
+      for (i=1;i<S->nW;i++)
+     {
+      j = (w+i) % S->nW;
+      lock_guard<mutex> g(S->W[j].m);
+      if ( !S->W[j].Fall.empty() ) { f = S->W[j].Fall.back(); S->W[j].Fall.pop_back(); return true; }
+     }
+
+      return false;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von FallHolen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FallRechnen
+      ----------------------------------------------------------------------- */
+
+      void FallRechnen(Studie *S, int f)
+     {
+
+   /* Ein Fall wie main, aber ohne Bildschirm: Ausgaben und Meldungen
+      landen im Verzeichnis des Falls, Meldungen in konti.log. */
+
+      Kontext *K;              // Rechenlauf
+
+      ofstream Log;            // Meldungen des Laufs
+
+      string Text, Fehler;     // input.dat des Falls, Fehlermeldung
+
+      chrono::steady_clock::time_point T = chrono::steady_clock::now();
+
+      Text = S->Basis;
+
+      if ( !ParameterAendern(Text,S->Aenderung[f],Fehler) || !ParameterPruefen(Text,Fehler) )
+     {
+      lock_guard<mutex> g(S->Ausgabe);
+      cout << " >> Fehler: Fall " << S->Verzeichnis[f] << ": " << Fehler << "\n";
+      return;
+     }
+
+      mkdir( S->Verzeichnis[f].c_str(), 0755 );
+
+      Log.open( S->Verzeichnis[f] + "/konti.log" );
+
+      K = new Kontext();
+
+      K->Pfad     = S->Verzeichnis[f] + "/";
+      K->Eingabe  = Text;
+      K->Konsole  = &Log;
+      K->Speicher = &S->Speicher;
+
+      if ( !S->Gitter.empty() ) { K->GitterDaten = S->Gitter.data(); K->nGD = S->Gitter.size(); }
+
+      K->ParameterEinlesen();
+
+      if ( K->mesh == 1 && K->GitterDaten != NULL && K->nGD < 2*(K->imax+2) )  // Sonst abort() in SimulationVorbereiten
+     {
+      delete K;
+      lock_guard<mutex> g(S->Ausgabe);
+      cout << " >> Fehler: Fall " << S->Verzeichnis[f] << ": \"mesh.dat\" enthält zu wenige Zellen\n";
+      return;
+     }
+      K->SimulationVorbereiten();
+      K->ParameterAusgeben();
+      if ( K->PZ > 0 ) K->PararealDurchfuehren();
+      else             K->SimulationDurchfuehren();
+      K->ErgebnisseSpeichern();
+      K->ProgrammBeenden();
+
+      delete K;
+
+      Log.close();
+
+      lock_guard<mutex> g(S->Ausgabe);
+      cout << " Fall " << setw(20) << S->Verzeichnis[f] << " fertig nach "
+           << chrono::duration<double>( chrono::steady_clock::now() - T ).count() << " s\n" << flush;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von FallRechnen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ParameterAendern
+      ----------------------------------------------------------------------- */
+
+      bool ParameterAendern(string &Text, const string &Aenderung, string &Fehler)
+     {
+
+   /* In den Parameterzeilen von input.dat steht zuerst der Wert, dann der
+      Kurzname. Für jedes Name=Wert wird der Wert der Zeile mit diesem
+      Namen ersetzt (siehe ParameterZeile). */
+
+      size_t a, k;             // Zeilenanfang, Position von = bzw. Name
+
+      string Paar, Name, Wert; // Name=Wert, Name, Wert
+
+      istringstream z(Aenderung);
+
+      while ( z >> Paar )
+     {
+
+      k = Paar.find('=');
+
+      if ( k == string::npos ) { Fehler = "\"" + Paar + "\" ist nicht von der Form Name=Wert"; return false; }
+
+      Name = Paar.substr(0,k);
+      Wert = Paar.substr(k+1);
+
+      if ( !ParameterZeile(Text,Name,a,k) ) { Fehler = "Unbekannter Parameter \"" + Name + "\""; return false; }
+
+      k = k - a;  // Spalte des Namens bleibt erhalten
+      Text.replace( a, k, " " + Wert + string( ( k > Wert.size() + 2 ) ? k - Wert.size() - 1 : 1, ' ' ) );
+
+     }
+
+      return true;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ParameterAendern
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ParameterZeile
+      ----------------------------------------------------------------------- */
+
+      bool ParameterZeile(const string &Text, const string &Name, size_t &a, size_t &k)
+     {
+
+   /* Sucht die Parameterzeile mit dem Kurznamen Name und liefert ihren
+      Anfang a und den Anfang k des Namens. Die Parameterzeilen enden mit
+      der ersten Leerzeile. Ohne istringstream je Zeile, der Dienst ruft
+      das für jeden Fall auf. */
+
+      size_t e, m;             // Zeilenende, Namensende
+
+      const char *L = " \t\r"; // Leerzeichen zwischen Wert und Name
+
+      for (a=0;a<Text.size();a=e+1)
+     {
+      e = Text.find('\n',a);
+      if ( e == string::npos ) e = Text.size();
+
+      k = Text.find_first_not_of(L,a);                 // Anfang des Werts
+      if ( k >= e ) break;                             // Leerzeile: Ende der Parameter
+
+      k = Text.find_first_of(L,k);                     // Ende des Werts
+      if ( k >= e ) continue;
+      k = Text.find_first_not_of(L,k);                 // Anfang des Namens
+      if ( k >= e ) continue;
+      m = min( Text.find_first_of(L,k), e );           // Ende des Namens
+
+      if ( Text.compare(k,m-k,Name) == 0 ) return true;
+     }
+
+      return false;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ParameterZeile
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ParameterPruefen
+      ----------------------------------------------------------------------- */
+
+      bool ParameterPruefen(const string &Text, string &Fehler)
+     {
+
+   /* Prüft vorab, was ParameterEinlesen und FeldgruppenVorbereiten mit
+      abort() beenden oder ungeprüft als Index verwenden würden: die
+      Versionsnummer, RBW, RBO, TV, die Funktionen uF, rF, wF, oF, imax und
+      bei EM, NS > 0 die Dateien ensemble.dat und skalare.dat. Parameter-
+      studie, Dienst und Bibliothek melden so einen fehlerhaften Fall, statt
+      den Prozess zu beenden. */
+
+      int i, j, l;             // Schleifenzähler
+
+      int W[10];               // Gelesene Werte
+
+      size_t a, k;             // Zeilenanfang, Position des Namens
+
+      double q[19];            // Eine Zeile von ensemble.dat bzw. skalare.dat
+
+      string V;                // Versionsnummer von input.dat
+
+      const char *Name[10] = { "RBW", "RBO", "TV", "uF", "rF", "wF", "oF", "imax", "EM", "NS" };
+      const int   Min [10] = { 0, 0, 0, 0, 0, 0, 0, 1, 0, 0 };
+      const int   Max [10] = { Kontext::OutletBoundary, Kontext::OutletBoundary, Kontext::SuperbeeLimiter,
+                               Kontext::FM, Kontext::FM, Kontext::FM, Kontext::FM, INT_MAX, INT_MAX, INT_MAX };
+
+      istringstream fin(Text);
+
+      ifstream Datei;
+
+      fin.ignore(80,'\n');
+      fin.ignore(80,'\n');
+      fin.ignore(80,'\n');
+      fin.ignore(26,'\n'); fin >> V;
+
+      if ( V != CppVersion ) { Fehler = "Versionsnummer \"" + V + "\" von input.dat passt nicht zu " + CppVersion; return false; }
+
+      for (i=0;i<10;i++)
+     {
+      if ( !ParameterZeile(Text,Name[i],a,k) ) { Fehler = string("Parameter ") + Name[i] + " fehlt"; return false; }
+      istringstream w( Text.substr(a,k-a) );
+      if ( !( w >> W[i] ) || W[i] < Min[i] || W[i] > Max[i] ) { Fehler = string("Unzulässiger Wert für ") + Name[i]; return false; }
+     }
+
+      if ( W[8] > 0 )  // EM Zeilen mit je 14 Werten
+     {
+      Datei.open("ensemble.dat");
+      for (j=0;j<W[8];j++) for (l=0;l<14;l++) Datei >> q[l];
+      if ( !Datei ) { Fehler = "\"ensemble.dat\" fehlt oder enthält zu wenige Zeilen"; return false; }
+      Datei.close();
+     }
+
+      if ( W[9] > 0 )  // NS Zeilen mit je 19 Werten: rF r1..r6 RBW wF w1..w4 RBO oF o1..o4
+     {
+      Datei.open("skalare.dat");
+      for (j=0;j<W[9];j++)
+     {
+      for (l=0;l<19;l++) Datei >> q[l];
+      if ( !Datei ) { Fehler = "\"skalare.dat\" fehlt oder enthält zu wenige Zeilen"; return false; }
+      if ( q[ 0] < 0 || q[ 0] > Kontext::FM || q[ 8] < 0 || q[ 8] > Kontext::FM || q[14] < 0 || q[14] > Kontext::FM )
+     {
+      Fehler = "Unbekannte Funktion rF, wF oder oF in \"skalare.dat\""; return false;
+     }
+      if ( q[ 7] < 0 || q[ 7] > Kontext::OutletBoundary || q[13] < 0 || q[13] > Kontext::OutletBoundary )
+     {
+      Fehler = "Unbekannte Randbedingung RBW oder RBO in \"skalare.dat\""; return false;
+     }
+     }
+      Datei.close();
+     }
+
+      return true;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ParameterPruefen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von Bibliotheksschnittstelle (siehe konti.h)
+      ----------------------------------------------------------------------- */
+
+      Kontext *KontiErzeugen(const char *Eingabe, const char *Aenderung,
+                             const double *Gitter, int nGitter, ostream *Meldungen)
+     {
+
+   /* Wie main bis SimulationVorbereiten, aber ohne Bildschirm und
+      Ausgabedateien. Danach rechnet KontiRechnen Schritt für Schritt.
+      Fehlerhafte Parameter oder ein zu kurzes Gitter werden wie im Dienst
+      vorab geprüft und nach Meldungen gemeldet, Ergebnis NULL. */
+
+      Kontext *K;            // Rechenlauf
+
+      string Text, Fehler;   // input.dat des Laufs, Fehlermeldung
+
+      K = new Kontext();
+
+      K->Konsole = ( Meldungen != NULL ) ? Meldungen : &K->Stumm;
+
+      if ( Eingabe != NULL ) Text = Eingabe;
+
+      if ( Text.empty() )  // Wie ParameterEinlesen, aber vorab prüfbar
+     {
+      ifstream fdat("input.dat");
+      ostringstream Inhalt;
+      Inhalt << fdat.rdbuf();
+      Text = Inhalt.str();
+     }
+
+      if ( ( Aenderung != NULL && !ParameterAendern(Text,Aenderung,Fehler) ) || !ParameterPruefen(Text,Fehler) )
+     {
+      *K->Konsole << " >> Fehler: " << Fehler << "\n";
+      delete K;
+      return NULL;
+     }
+
+      K->Eingabe = Text;
+
+      K->ParameterEinlesen();
+
+      if ( Gitter != NULL && nGitter < 2*(K->imax+2) )  // Sonst abort() in SimulationVorbereiten
+     {
+      *K->Konsole << " >> Fehler: Gitter mit " << nGitter << " Werten, erwartet 2*(imax+2) = " << 2*(K->imax+2) << "\n";
+      delete K;
+      return NULL;
+     }
+
+      if ( Gitter != NULL ) { K->mesh = 1; K->GitterDaten = Gitter; K->nGD = nGitter; }
+
+      K->BibliothekVorbereiten();
+
+      K->GitterDaten = NULL;  // Gehört dem Aufrufer
+
+      return K;
+
+     }
+
+      void KontiLoeschen(Kontext *K)
+     {
+      delete K;
+     }
+
+      int KontiZellen(Kontext *K)
+     {
+      return K->imax;
+     }
+
+      double *KontiGitterX(Kontext *K)
+     {
+      return K->x;
+     }
+
+      double *KontiGitterDX(Kontext *K)
+     {
+      return K->dx;
+     }
+
+      double *KontiGeschwindigkeit(Kontext *K)
+     {
+      return K->u;
+     }
+
+      double *KontiDichte(Kontext *K)
+     {
+      return K->rho;
+     }
+
+      void KontiGeaendert(Kontext *K)
+     {
+      K->VG++;  // Koeffizienten und Zerlegung im nächsten Schritt neu
+     }
+
+      unsigned long KontiRechnen(Kontext *K, unsigned long n)
+     {
+      return K->SchritteRechnen(n);
+     }
+
+      double KontiZeit(Kontext *K)
+     {
+      return ( K->nK == 0 ) ? K->ta + K->n0*K->dt : K->t;
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von Bibliotheksschnittstelle
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DienstDurchfuehren
+      ----------------------------------------------------------------------- */
+
+      void DienstDurchfuehren(const char *Adresse)
+     {
+
+   /* Der Dienst bleibt im Speicher und rechnet jede Zeile, die er erhält,
+      als einen Fall (siehe DienstFall). Ohne Adresse liest er von stdin
+      und antwortet auf stdout, sonst nimmt er am Unix-Socket Adresse
+      eine Verbindung nach der anderen an, bis er beendet wird. input.dat
+      wird einmal gelesen, Gitterdateien und Koeffizientensätze bleiben
+      über alle Fälle und Verbindungen erhalten. */
+
+      int s, c;                // Socket, Verbindung
+
+      sockaddr_un a;           // Adresse des Sockets
+
+      FILE *Ein, *Aus;         // Ströme der Verbindung
+
+      ifstream fin;            // Eingabeobjekt
+
+      ostringstream Inhalt;    // Inhalt von input.dat
+
+      Dienst *D = new Dienst;  // Gemeinsame Daten
+
+      fin.open("input.dat");
+      Inhalt << fin.rdbuf();
+      D->Basis = Inhalt.str();
+      fin.close();
+
+      if ( Adresse == NULL )
+     {
+      DienstVerbindung(D,stdin,stdout);
+      delete D;
+      return;
+     }
+
+      signal(SIGPIPE,SIG_IGN);  // Abgebrochene Verbindung beendet nicht den Dienst
+
+      memset(&a,0,sizeof(a));
+      a.sun_family = AF_UNIX;
+      strncpy(a.sun_path,Adresse,sizeof(a.sun_path)-1);
+
+      unlink(Adresse);
+
+      s = socket(AF_UNIX,SOCK_STREAM,0);
+
+      if ( s < 0 || bind(s,(sockaddr*)&a,sizeof(a)) != 0 || listen(s,8) != 0 )
+     {
+      cout << "\n >> Fehler: Socket \"" << Adresse << "\" nicht verfügbar !\n\n";
+      delete D;
+      return;
+     }
+
+      cout << "\n Dienst wartet auf " << Adresse << "\n\n" << flush;
+
+      for (;;)
+     {
+      c = accept(s,NULL,NULL);
+      if ( c < 0 ) continue;
+      Ein = fdopen(c,"r");
+      Aus = fdopen(dup(c),"w");
+      DienstVerbindung(D,Ein,Aus);
+      fclose(Ein);
+      fclose(Aus);
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DienstDurchfuehren
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DienstVerbindung
+      ----------------------------------------------------------------------- */
+
+      void DienstVerbindung(Dienst *D, FILE *Ein, FILE *Aus)
+     {
+
+   /* Eine Zeile je Fall, bis die Gegenseite die Verbindung schließt.
+      Leere Zeilen und Zeilen mit # am Anfang werden überlesen. */
+
+      char *Puffer = NULL;     // Von getline verwaltet
+      size_t nP = 0;           // Größe von Puffer
+      ssize_t l;               // Länge der Zeile
+
+      string Zeile;            // Beschreibung des Falls
+
+      while ( ( l = getline(&Puffer,&nP,Ein) ) >= 0 )
+     {
+      Zeile.assign(Puffer,l);
+      istringstream z(Zeile);
+      string w;
+      if ( !( z >> w ) || w[0] == '#' ) continue;
+      DienstFall(D,Zeile,Aus);
+      fflush(Aus);
+     }
+
+      free(Puffer);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DienstVerbindung
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DienstFall
+      ----------------------------------------------------------------------- */
+
+      void DienstFall(Dienst *D, const string &Zeile, FILE *Aus)
+     {
+
+   /* Ein Fall ist eine Zeile "Name=Wert ..." wie im Manifest einer
+      Parameterstudie, dazu optional Gitter=<Datei> statt mesh.dat (setzt
+      mesh = 1). Eine Zeile mit - rechnet input.dat unverändert. Der Lauf
+      schreibt keine Dateien und keine Meldungen, zurück geht ein
+      Datensatz im Maschinenformat:
+
+           int    Status        0 = gerechnet
+           int    n             imax+2
+           double t, M, Ek, px  Endzeitpunkt und Diagnosegrößen
+           double rho[n]        Dichte samt Geisterzellen
+
+      oder bei einem Fehler:
+
+           int    Status        1 = Fehler
+           int    n             Länge der Meldung
+           char   Meldung[n]
+
+      Fehler sind unbekannte Parameter, unzulässige RBW, RBO, TV oder
+      AZ > 0, eine falsche Versionsnummer und fehlende Gitterdateien. */
+
+      int i, n;                      // Schleifenzähler, Feldlänge
+
+      double h[4];                   // t, M, Ek, px
+
+      double w;                      // Wert aus der Gitterdatei
+
+      Kontext *K;                    // Rechenlauf
+
+      string Text, Aenderung;        // input.dat des Falls, Name=Wert ...
+
+      string Paar, Datei, Fehler;    // Eintrag der Zeile, Gitterdatei, Fehlermeldung
+
+      bool Gitter = false;           // Gitterdatei angegeben
+
+      ifstream fin;                  // Eingabeobjekt
+
+      map< string, vector<double> >::iterator g;
+
+      Datei = "mesh.dat";
+
+      istringstream z(Zeile);
+
+      while ( z >> Paar )
+     {
+      if ( Paar == "-" ) continue;
+      if ( Paar.compare(0,7,"Gitter=") == 0 ) { Datei = Paar.substr(7); Gitter = true; }
+      else                                      Aenderung += " " + Paar;
+     }
+
+      Text = D->Basis;
+
+      if ( !ParameterAendern(Text,Aenderung,Fehler) ) { DienstFehler(Aus,Fehler); return; }
+
+      if ( !DienstPruefen(Text,Fehler) ) { DienstFehler(Aus,Fehler); return; }
+
+      K = new Kontext();
+
+      K->Konsole  = &K->Stumm;
+      K->Eingabe  = Text;
+      K->Speicher = &D->Speicher;
+
+      K->ParameterEinlesen();
+
+      if ( Gitter ) K->mesh = 1;
+
+   /* Gitterdatei nur beim ersten Fall mit diesem Namen lesen */
+
+      if ( K->mesh == 1 )
+     {
+      g = D->Gitter.find(Datei);
+      if ( g == D->Gitter.end() )
+     {
+      fin.open(Datei);
+      if ( !fin ) { delete K; DienstFehler(Aus,"Gitterdatei \"" + Datei + "\" nicht gefunden"); return; }
+      vector<double> v;
+      while ( fin >> w ) v.push_back(w);
+      fin.close();
+      g = D->Gitter.insert( make_pair( Datei, v ) ).first;
+     }
+      if ( (int)g->second.size() < 2*(K->imax+2) )
+     {
+      delete K;
+      DienstFehler(Aus,"\"" + Datei + "\" enthält zu wenige Zellen");
+      return;
+     }
+      K->GitterDaten = g->second.data();
+      K->nGD         = g->second.size();
+     }
+
+      K->BibliothekVorbereiten();
+
+      K->SchritteRechnen( ( K->ZA == Kontext::FixedTimeStep ) ? K->nmax : ULONG_MAX );  // ZA = 1: bis te
+
+      K->DiagnoseBerechnen();
+
+      i = 0;
+      n = K->imax + 2;
+      h[0] = K->t; h[1] = K->M; h[2] = K->Ek; h[3] = K->px;
+
+      fwrite(&i,sizeof(int),1,Aus);
+      fwrite(&n,sizeof(int),1,Aus);
+      fwrite(h,sizeof(double),4,Aus);
+      fwrite(K->rho,sizeof(double),n,Aus);
+
+      delete K;
+
+   /* Leeren ist nur hier erlaubt: der Dienst rechnet einen Fall nach dem
+      anderen, kein Lauf hält gerade einen Zeiger in den Speicher */
+
+      if ( D->Speicher.Satz.size() > Dienst::SatzMax ) D->Speicher.Satz.clear();
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DienstFall
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DienstPruefen
+      ----------------------------------------------------------------------- */
+
+      bool DienstPruefen(const string &Text, string &Fehler)
+     {
+
+   /* Wie ParameterPruefen, zusätzlich nur AZ = 0: AZ > 0 liest Dateien
+      früherer Läufe, die der Dienst nicht schreibt. Ein fehlerhafter Fall
+      soll dem Aufrufer gemeldet werden, nicht den Dienst beenden. */
+
+      int j;                   // Wert von AZ
+
+      size_t a, k;             // Zeilenanfang, Position des Namens
+
+      if ( !ParameterPruefen(Text,Fehler) ) return false;
+
+      if ( !ParameterZeile(Text,"AZ",a,k) ) { Fehler = "Parameter AZ fehlt"; return false; }
+      istringstream w( Text.substr(a,k-a) );
+      if ( !( w >> j ) || j != 0 ) { Fehler = "Unzulässiger Wert für AZ"; return false; }
+
+      return true;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DienstPruefen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DienstFehler
+      ----------------------------------------------------------------------- */
+
+      void DienstFehler(FILE *Aus, const string &Fehler)
+     {
+
+      int i = 1, n = Fehler.size();  // Status, Länge der Meldung
+
+      fwrite(&i,sizeof(int),1,Aus);
+      fwrite(&n,sizeof(int),1,Aus);
+      fwrite(Fehler.data(),1,n,Aus);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DienstFehler
+      ----------------------------------------------------------------------- */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von HilfsfelderBerechnenPBC
+      ------------------------------------------------------------------ */
+
+      void Kontext::HilfsfelderBerechnenPBC(void)
+     {
+
+      int i;                    // Lokaler Schleifenzähler
+
+      for (i=imin;i<=imax;i++) dtdx[i] = a0*dt/dx[i];
+
+      for (i=imin;i<=imax;i++)  // Standard für alle Zellen
+     {
+      aW[i] = - ( u[i-1] + fabs(u[i-1]) ) * dtdx[i]/2.0 ;
+      aP[i] =       1.0  + fabs(u[ i ])   * dtdx[i]     ;
+      aE[i] =   ( u[i+1] - fabs(u[i+1]) ) * dtdx[i]/2.0 ;
+     }
+
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von HilfsfelderBerechnenPBC
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von HilfsfelderBerechnenSTD
+      ------------------------------------------------------------------ */
+
+      void Kontext::HilfsfelderBerechnenSTD(void)
+     {
+
+      int i;                        // Lokaler Schleifenzähler
+
+      for (i=imin;i<=imax;i++) dtdx[i] = a0*dt/dx[i];
+
+      for (i=imin+1;i<=imax-1;i++)  // Standard für innere Zellen
+     {
+      aW[i] = - ( u[i-1] + fabs(u[i-1]) ) * dtdx[i]/2.0 ;
+      aP[i] =       1.0  + fabs(u[ i ])   * dtdx[i]     ;
+      aE[i] =   ( u[i+1] - fabs(u[i+1]) ) * dtdx[i]/2.0 ;
+     }
+
+   /* ----------------------------------------------------------------------- */
+
+      if ( RBW == WallBoundary )  // Kein Fluss zwischen W und P
+     {
+
+         i  = imin                                            ;
+      aW[i] = 0.0                                             ;
+      aP[i] = 1.0  + ( u[ i ] + fabs(u[ i ]) ) * dtdx[i]/2.0 ;
+      aE[i] =        ( u[i+1] - fabs(u[i+1]) ) * dtdx[i]/2.0 ;
+      
+     }
+
+      if ( RBO == WallBoundary )  // Kein Fluss zwischen E und P
+     {
+
+         i  = imax                                            ;
+      aW[i] =      - ( u[i-1] + fabs(u[i-1]) ) * dtdx[i]/2.0 ;
+      aP[i] = 1.0  - ( u[ i ] - fabs(u[ i ]) ) * dtdx[i]/2.0 ;
+      aE[i] = 0.0  ;
+      
+     }
+
+   /* ----------------------------------------------------------------------- */
+
+      if ( RBW == DirichletBoundary || RBW == DynamicBoundary || RBW == NeumannBoundary )  // Kein Fluss von P nach W
+     {
+
+         i  = imin                                            ;
+      aW[i] =      - ( u[i-1] + fabs(u[i-1]) ) * dtdx[i]/2.0 ;
+      aP[i] = 1.0  + ( u[ i ] + fabs(u[ i ]) ) * dtdx[i]/2.0 ;
+      aE[i] =        ( u[i+1] - fabs(u[i+1]) ) * dtdx[i]/2.0 ;
+
+     }
+
+      if ( RBO == DirichletBoundary || RBO == DynamicBoundary || RBO == NeumannBoundary )  // Kein Fluss von P nach E
+     {
+
+         i  = imax                                            ;
+      aW[i] =      - ( u[i-1] + fabs(u[i-1]) ) * dtdx[i]/2.0 ;
+      aP[i] = 1.0  - ( u[ i ] - fabs(u[ i ]) ) * dtdx[i]/2.0 ;
+      aE[i] =        ( u[i+1] - fabs(u[i+1]) ) * dtdx[i]/2.0 ;
+      
+     }
+
+   /* ----------------------------------------------------------------------- */
+
+      if ( RBW == OutletBoundary )     // Kein Fluss von W nach P
+     {
+
+          i = imin                                       ;
+      aW[i] =       0.0                                  ;
+      aP[i] =       1.0  + fabs(u[ i ])   * dtdx[i]     ;
+      aE[i] =   ( u[i+1] - fabs(u[i+1]) ) * dtdx[i]/2.0 ;
+
+     }
+
+      if ( RBO == OutletBoundary )     // Kein Fluss von E nach P
+     {
+          i = imax                                       ;
+      aW[i] = - ( u[i-1] + fabs(u[i-1]) ) * dtdx[i]/2.0 ;
+      aP[i] =       1.0  + fabs(u[ i ])   * dtdx[i]     ;
+      aE[i] =       0.0                                  ;
+
+     }
+
+   /* ----------------------------------------------------------------------- */
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von HilfsfelderBerechnenSTD
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von KoeffizientenAktualisieren
+      ------------------------------------------------------------------ */
+
+      void Kontext::KoeffizientenAktualisieren(void)
+     {
+
+   /* Da u(x) stationär ist, hängen Koeffizienten und Zerlegung nur von
+      a0*dt, dem Gitter und u ab. Wer Gitter oder u ändert, erhöht VG. */
+
+      int i;  // Lokaler Schleifenzähler
+
+      if ( a0*dt == dtF && VG == VF ) return;
+
+      if ( Speicher != NULL && ZA == FixedTimeStep && ZV != SemiLagrangeScheme )  // Parameterstudie, dt fest
+     {
+      KoeffizientenTeilen();
+     }
+      else
+     {
+
+      if ( ZV == SemiLagrangeScheme )  // Keine Matrix, nur die Abfahrtspunkte
+     {
+      AbfahrtspunkteBerechnen();
+      if ( nG > 0 ) FeldgruppenKoeffizienten();
+      dtF = a0*dt;
+      VF  = VG;
+      return;
+     }
+
+      (this->*HilfsfelderBerechnen)();
+
+      for (i=imin;i<=imax;i++) raP[i] = 1.0/aP[i];  // Gauß-Seidel ohne Division
+
+      if ( LS == ThomasSolver || nF > 0 ) (this->*Faktorisieren)();     // Auch für die Zusatzfelder
+
+     }
+      if ( LS == ParallelSolver         ) FaktorisierenPAR();
+      if ( LS == RedBlackSolver         ) RelaxationSchaetzen();
+      if ( SK == AdaptiveStop           ) KonvergenzrateSchaetzen();
+      if ( LS == MultigridSolver        ) MehrgitterAufbauen();
+      if ( LS == BiCGStabSolver || LS == GMRESSolver ) KrylovAufbauen();
+
+      if ( nG > 0 ) FeldgruppenKoeffizienten();
+
+      dtF = a0*dt;
+      VF  = VG;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von KoeffizientenAktualisieren
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von KoeffizientenTeilen
+      ------------------------------------------------------------------ */
+
+      void Kontext::KoeffizientenTeilen(void)
+     {
+
+   /* Hilfsfelder, Kehrwerte der Diagonale und LR-Zerlegung hängen nur
+      von a0*dt, den Randbedingungen, dem Gitter und u ab. Läufe einer
+      Parameterstudie mit gleichen Werten berechnen sie nur einmal, die
+      übrigen kopieren sie aus dem gemeinsamen Speicher. */
+
+      int i, l;                  // Lokale Schleifenzähler
+      int n = imax + 2;          // Feldlänge mit Geisterzellen
+
+      double h[3];               // Schlüssel: a0*dt und Randbedingungen
+      double *F[8] = { dtdx, aW, aP, aE, raP, cT, rP, zT };
+
+      string s;                  // Schlüssel
+      vector<double> v;          // Neuer Satz
+      const vector<double> *w;   // Gespeicherter Satz
+
+      h[0] = a0*dt; h[1] = RBW; h[2] = RBO;
+
+      s.append( (char*)h , 3*sizeof(double) );
+      s.append( (char*)x , n*sizeof(double) );
+      s.append( (char*)dx, n*sizeof(double) );
+      s.append( (char*)u , n*sizeof(double) );
+
+     {
+      lock_guard<mutex> g(Speicher->m);
+      map< string, vector<double> >::iterator e = Speicher->Satz.find(s);
+      w = ( e == Speicher->Satz.end() ) ? NULL : &e->second;  // Nur DienstFall leert, zwischen zwei Läufen
+     }
+
+      if ( w != NULL )
+     {
+      for (l=0;l<8;l++) memcpy( F[l], w->data() + l*n, n*sizeof(double) );
+      zS = (*w)[8*n]; vZ = (*w)[8*n+1];
+      return;
+     }
+
+      (this->*HilfsfelderBerechnen)();
+
+      for (i=imin;i<=imax;i++) raP[i] = 1.0/aP[i];
+
+      (this->*Faktorisieren)();  // Unabhängig von LS, damit jeder Lauf den Satz nutzen kann
+
+      v.resize(8*n+2);
+      for (l=0;l<8;l++) memcpy( v.data() + l*n, F[l], n*sizeof(double) );
+      v[8*n] = zS; v[8*n+1] = vZ;
+
+      lock_guard<mutex> g(Speicher->m);
+      Speicher->Satz.insert( make_pair( s, v ) );
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von KoeffizientenTeilen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ZeitebenenSpeichern
+      ------------------------------------------------------------------ */
+
+      void Kontext::ZeitebenenSpeichern(void)
+     {
+
+   /* Zu Beginn eines Zeitschritts: rhoC <- rhoB <- rhoA <- rho. Die
+      Felder werden nur umgehängt, kopiert wird allein rho. */
+
+      int i;          // Schleifenzähler
+
+      double *h;      // Hilfszeiger
+
+      h = rhoC; rhoC = rhoB; rhoB = rhoA; rhoA = h;
+
+      for (i=imin-1;i<=imax+1;i++) rhoA[i] = rho[i];
+
+      if ( nA < 3 ) nA++;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ZeitebenenSpeichern
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ZeitschrittWaehlen
+      ------------------------------------------------------------------ */
+
+      void Kontext::ZeitschrittWaehlen(void)
+     {
+
+   /* Schrittweite für den nächsten Versuch ab tS: Vorschlag dtN, begrenzt
+      auf [dtmin,dtmax], auf die Courant-Zahl CFL und auf das Restintervall
+      bis te. Der letzte Schritt endet genau auf te. */
+
+      int i;          // Schleifenzähler
+
+      double c;       // Größtes |u|/dx
+
+      dt = dtN;
+
+      if ( dt > dtmax ) dt = dtmax;
+      if ( dt < dtmin ) dt = dtmin;
+
+      if ( CFL > 0.0 )
+     {
+      c = 0.0;
+      for (i=imin;i<=imax;i++) c = ( fabs(u[i])/dx[i] > c ) ? fabs(u[i])/dx[i] : c;
+      if ( c > 0.0 && dt > CFL/c ) dt = CFL/c;
+     }
+
+      if ( tS + dt >= te ) { dt = te - tS; t = te; }
+      else                 {               t = tS + dt; }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ZeitschrittWaehlen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ZeitschrittAnnehmen
+      ------------------------------------------------------------------ */
+
+      bool Kontext::ZeitschrittAnnehmen(void)  // false: Schritt verworfen, rho zurückgesetzt
+     {
+
+   /* Eingebettete Fehlerschätzung des impliziten Euler-Verfahrens: der
+      lineare Prädiktor P = rho^n + dt/dtV (rho^n - rho^(n-1)) ist von
+      gleicher Ordnung, aber mit anderem Fehlerterm. Mit rho^(n+1) - P
+      = rho''/2 dt (2 dt + dtV) und dem Euler-Fehler rho''/2 dt^2 ist der
+      lokale Fehler etwa
+
+           E = dt/(2 dt+dtV) * max|rho^(n+1) - P|
+
+      (1/3 max|rho^(n+1) - P| bei konstanter Schrittweite).
+
+      Bei BDF2 und Crank-Nicolson (ZV > 0) ist der Fehler von dritter
+      Ordnung. Dann tritt an die Stelle von P die quadratische Extrapolation
+      P2 aus rho^n, rho^(n-1), rho^(n-2) (Lagrange mit den tatsächlichen
+      Schrittweiten, siehe ExtrapolationWaehlen), und mit den Fehlerkonstanten 2/9 (BDF2) bzw. 1/12
+      (Crank-Nicolson) gegenüber 1 für P2 gilt E = 2/11 bzw. 1/13
+      max|rho^(n+1) - P2|. Für Theta != 1/2 kommt |1-2 Theta| mal diese
+      Euler-Schätzung E hinzu, die Ordnung bleibt dann eins.
+
+      Mit r = E/(tol max|rho^n|) wird der Schritt bei r <= 1 angenommen
+      (oder wenn dt = dtmin), der nächste Vorschlag ist dt 0.9 r^(-1/(p+1))
+      bei Ordnung p, höchstens verdoppelt, mindestens auf 1/5 verkleinert.
+      Wachstum unter
+      20 % wird unterdrückt, damit Koeffizienten, Zerlegungen und
+      Mehrgitter-Hierarchie nicht in jedem Schritt neu entstehen. Ohne
+      genügend alte Zeitebenen wird ohne Schätzung angenommen. */
+
+      int i;          // Schleifenzähler
+
+      double E, F, m, r, q;
+      double p;       // Ordnung des Verfahrens
+
+      p = ( ZV == BDF2Scheme || ( ZV == ThetaScheme && th == 0.5 ) ) ? 2.0 : 1.0;
+
+      if ( nA < 2 || dtV <= 0.0 || ( ZV != ImplicitEuler && ( nA < 3 || dtVV <= 0.0 ) ) )
+     {
+      q = 1.0;
+     }
+      else
+     {
+
+      E = 0.0; F = 0.0; m = 0.0;
+
+      for (i=imin;i<=imax;i++)
+     {
+      r = fabs( rho[i] - rhoA[i] - wL*( rhoA[i] - rhoB[i] ) );
+      E = ( r > E ) ? r : E;
+      m = ( fabs(rhoA[i]) > m ) ? fabs(rhoA[i]) : m;
+      if ( ZV == ImplicitEuler ) continue;
+      r = fabs( rho[i] - lA*rhoA[i] - lB*rhoB[i] - lC*rhoC[i] );
+      F = ( r > F ) ? r : F;
+     }
+
+      E = E*dt/( 2.0*dt + dtV );
+
+      if ( ZV == BDF2Scheme  ) E = F*2.0/11.0;
+      if ( ZV == ThetaScheme ) E = F/13.0 + fabs(1.0-2.0*th)*E;
+
+      r = E/( tol*( ( m > 0.0 ) ? m : 1.0 ) );
+
+      q = ( r > 0.0 ) ? 0.9/( ( p == 1.0 ) ? sqrt(r) : cbrt(r) ) : 2.0;
+      if ( q > 2.0 ) q = 2.0;
+      if ( q < 0.2 ) q = 0.2;
+
+      if ( r > 1.0 && dt > dtmin )  // Verwerfen: rho zurücksetzen
+     {
+      for (i=imin-1;i<=imax+1;i++) rho[i] = rhoA[i];
+      dtN = dt*q;
+      NR++;
+      return false;
+     }
+
+     }
+
+      if ( q < 1.0 || q > 1.2 ) dtN = dt*q;
+      else                      dtN = dt;
+
+      dtVV = dtV;
+      dtV  = dt;
+      tS   = t;
+
+      if ( dt < dtK && t < te ) dtK = dt;  // Letzten, gekürzten Schritt nicht zählen
+      if ( dt > dtG           ) dtG = dt;
+
+      return true;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ZeitschrittAnnehmen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ZeitverfahrenWaehlen
+      ------------------------------------------------------------------ */
+
+      void Kontext::ZeitverfahrenWaehlen(void)
+     {
+
+   /* Alle Verfahren führen auf A f = b mit der Matrix des Euler-Schritts
+      zur Schrittweite a0*dt, also auf dieselben Koeffizienten, Zerlegungen
+      und Löser. Nur a0 und die rechte Seite b ändern sich:
+
+           BDF2:   a0 = (1+w)/(1+2w),  b = bA rho^n - bB rho^(n-1),
+                   bA = (1+w) a0, bB = w^2/(1+w) a0, w = dt/dtV
+                   (konstantes dt: a0 = 2/3, bA = 4/3, bB = 1/3)
+           Theta:  a0 = Theta,         b = rho^n - (1-Theta) dt L rho^n
+
+      Der erste BDF2-Schritt (und der erste nach einem Neustart ohne alte
+      Zeitebene) ist ein Euler-Schritt. */
+
+      double w;       // Verhältnis der Schrittweiten
+
+      if ( ZV == BDF2Scheme )
+     {
+      if ( nA >= 2 )
+     {
+      w  = ( dtV > 0.0 ) ? dt/dtV : 1.0;
+      a0 = ( 1.0 + w )/( 1.0 + 2.0*w );
+      bA = ( 1.0 + w )*a0;
+      bB = w*w/( 1.0 + w )*a0;
+     }
+      else
+     {
+      a0 = 1.0; bA = 1.0; bB = 0.0;
+     }
+     }
+
+      if ( ZV == ThetaScheme ) a0 = th;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ZeitverfahrenWaehlen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ExtrapolationWaehlen
+      ------------------------------------------------------------------ */
+
+      void Kontext::ExtrapolationWaehlen(void)
+     {
+
+   /* Gewichte der Extrapolation auf t + dt aus rho^n, rho^(n-1) und
+      rho^(n-2) mit den tatsächlichen Schrittweiten dt, dtV und dtVV,
+      für Prädiktor (PR = 1, 2) und Fehlerschätzung (ZA = 1):
+
+           linear:       P  = rho^n + wL (rho^n - rho^(n-1)),  wL = dt/dtV
+           quadratisch:  P2 = lA rho^n + lB rho^(n-1) + lC rho^(n-2)
+
+      mit den Lagrange-Gewichten
+
+           lA =   (dt+dtV) (dt+dtV+dtVV) / (dtV (dtV+dtVV))
+           lB = - dt (dt+dtV+dtVV) / (dtV dtVV)
+           lC =   dt (dt+dtV) / ((dtV+dtVV) dtVV)
+
+      Bei konstanter Schrittweite (und solange dtV oder dtVV fehlen) gelten
+      die Werte wL = 1, lA = 3, lB = -3, lC = 1. */
+
+      wL = 1.0; lA = 3.0; lB = -3.0; lC = 1.0;
+
+      if ( dtV <= 0.0 ) return;
+
+      wL = dt/dtV;
+
+      if ( dtVV <= 0.0 || ( dtV == dt && dtVV == dt ) ) return;
+
+      lA =  ( dt + dtV )*( dt + dtV + dtVV )/( dtV*( dtV + dtVV ) );
+      lB = - dt*( dt + dtV + dtVV )/( dtV*dtVV );
+      lC =  dt*( dt + dtV )/( ( dtV + dtVV )*dtVV );
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ExtrapolationWaehlen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von RechteSeiteBerechnen
+      ------------------------------------------------------------------ */
+
+      void Kontext::RechteSeiteBerechnen(void)
+     {
+
+   /* Ersetzt rho in den inneren Zellen durch die rechte Seite b, rho^n
+      liegt in rhoA, rho^(n-1) in rhoB. Der explizite Anteil des Theta-
+      Verfahrens verwendet A - I = Theta dt L und die Geisterzellen von
+      rho^n, also dieselbe Behandlung aller Randbedingungen wie der
+      implizite Anteil. */
+
+      int i;          // Schleifenzähler
+
+      double c;       // (1-Theta)/Theta
+
+      if ( ZV == BDF2Scheme && bB != 0.0 )
+      for (i=imin;i<=imax;i++) rho[i] = bA*rhoA[i] - bB*rhoB[i];
+
+      if ( ZV == ThetaScheme )
+     {
+      c = ( 1.0 - th )/th;
+      for (i=imin;i<=imax;i++)
+      rho[i] = rhoA[i] - c*( aW[i]*rhoA[i-1] + ( aP[i] - 1.0 )*rhoA[i] + aE[i]*rhoA[i+1] );
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von RechteSeiteBerechnen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von KorrekturZeitschritt
+      ------------------------------------------------------------------ */
+
+      void Kontext::KorrekturZeitschritt(void)
+     {
+
+   /* Deferred Correction: links bleibt die Upwind-Matrix, die Differenz
+      zwischen begrenztem Massenstrom 2. Ordnung und Upwind-Massenstrom
+      steht auf der rechten Seite. Der erste Durchgang wertet sie mit
+      rho^n aus, jeder weitere mit der Lösung des vorherigen. Beim
+      Theta-Verfahren erhält der explizite Anteil die Korrektur mit rho^n.
+      Bei PR > 0 startet jeder weitere Durchgang mit der vorherigen Lösung. */
+
+      int i, j;       // Schleifenzähler
+      int Ks;         // Summe der inneren Iterationen aller Durchgänge
+
+      double c;       // (1-Theta)/Theta
+
+      bool P;         // Periodische Ränder
+
+      P  = ( RBW == PeriodicBoundary );
+      Ks = 0;
+
+      for (i=imin;i<=imax;i++) rhoR[i] = rho[i];
+
+      KorrekturBerechnen( rhoA, 1, P );
+
+      if ( ZV == ThetaScheme )
+     {
+      c = ( 1.0 - th )/th;
+      for (i=imin;i<=imax;i++) rhoR[i] -= c*dtdx[i]*( fK[i] - fK[i-1] );
+     }
+
+      for (j=0;j<DK;j++)
+     {
+
+      if ( j > 0 ) KorrekturBerechnen( rho, 1, P );
+
+      if ( j > 0 && PR > 0 ) for (i=imin;i<=imax;i++) fS[i] = rho[i];
+
+      for (i=imin;i<=imax;i++) rho[i] = rhoR[i] - dtdx[i]*( fK[i] - fK[i-1] );
+
+      (this->*ImpliziterZeitschritt)();
+
+      Ks += KS;
+
+     }
+
+      KS = Ks;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von KorrekturZeitschritt
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von KorrekturBerechnen
+      ------------------------------------------------------------------ */
+
+      void Kontext::KorrekturBerechnen(double *q, int K, bool P)  // q[i*K]: Feld, P: periodisch
+     {
+
+   /* Die Upwind-Massenströme sind F+ = max(u,0) rho aus der westlichen und
+      F- = min(u,0) rho aus der östlichen Zelle. Beide werden mit einer
+      begrenzten Steigung (MUSCL) auf die Zellfläche extrapoliert, fK[i]
+      ist die Differenz zum Upwind-Massenstrom an der Ostseite der Zelle i.
+      Ohne periodische Ränder sind die Steigungen in den Randzellen null,
+      an den Randflächen bleibt es bei 1. Ordnung. */
+
+      int i, iW, iO;    // Schleifenzähler, Nachbarzellen
+
+      double hW, hO;    // Abstand zu den Nachbarzellen
+      double FW, FP, FO;// Massenströme der Zellen
+
+      fK[imin-1] = 0.0;
+
+      for (i=imin;i<=imax;i++)
+     {
+
+      fK[i] = 0.0;
+
+      if ( !P && ( i == imin || i == imax ) ) continue;
+
+      iW = ( i == imin ) ? imax : i-1;
+      iO = ( i == imax ) ? imin : i+1;
+
+      hW = x[ i ] - x[i-1];
+      hO = x[i+1] - x[ i ];
+
+      FW = ( u[iW] + fabs(u[iW]) )/2.0 * q[iW*K];  // F+ nach Osten
+      FP = ( u[ i] + fabs(u[ i]) )/2.0 * q[ i*K];
+      FO = ( u[iO] + fabs(u[iO]) )/2.0 * q[iO*K];
+
+      fK[ i ]  = dx[i]/2.0 * (this->*Begrenzer)( ( FP - FW )/hW, ( FO - FP )/hO );
+
+      FW = ( u[iW] - fabs(u[iW]) )/2.0 * q[iW*K];  // F- nach Westen
+      FP = ( u[ i] - fabs(u[ i]) )/2.0 * q[ i*K];
+      FO = ( u[iO] - fabs(u[iO]) )/2.0 * q[iO*K];
+
+      fK[i-1] -= dx[i]/2.0 * (this->*Begrenzer)( ( FP - FW )/hW, ( FO - FP )/hO );
+
+     }
+
+      if ( P )  // Ostseite von imax und Westseite von imin sind eine Fläche
+     {
+      fK[imax]  += fK[imin-1];
+      fK[imin-1] = fK[imax];
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von KorrekturBerechnen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von Minmod, VanLeer und Superbee
+      ------------------------------------------------------------------ */
+
+      double Kontext::Minmod(double a, double b)  // Begrenzte Steigung aus a und b
+     {
+      if ( a*b <= 0.0 ) return 0.0;
+      return ( fabs(a) < fabs(b) ) ? a : b;
+     }
+
+      double Kontext::VanLeer(double a, double b)
+     {
+      if ( a*b <= 0.0 ) return 0.0;
+      return 2.0*a*b/( a + b );
+     }
+
+      double Kontext::Superbee(double a, double b)
+     {
+      double s, m1, m2;
+      if ( a*b <= 0.0 ) return 0.0;
+      s  = ( a > 0.0 ) ? 1.0 : -1.0;
+      m1 = ( 2.0*fabs(a) < fabs(b) ) ? 2.0*fabs(a) : fabs(b);
+      m2 = ( fabs(a) < 2.0*fabs(b) ) ? fabs(a) : 2.0*fabs(b);
+      return s*( ( m1 > m2 ) ? m1 : m2 );
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von Minmod, VanLeer und Superbee
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von AbfahrtspunkteBerechnen
+      ------------------------------------------------------------------ */
+
+      void Kontext::AbfahrtspunkteBerechnen(void)
+     {
+
+   /* Semi-Lagrange (ZV = 3): von jeder Zellfläche wird die Charakteristik
+      dX/dt = u(X) um dt zurückverfolgt. u ist stückweise linear zwischen
+      den Knoten Westrand, Zellmittelpunkte, Ostrand. Auf jedem Stück gilt
+      u(X(s)) = u0 exp(-g s), die Laufzeit bis zum nächsten Knoten und der
+      Endpunkt sind daher exakt. Da u stationär ist, hängen die Punkte nur
+      von dt, dem Gitter und u ab und werden wie eine Zerlegung gespeichert.
+
+      Die Randgeschwindigkeit folgt den Massenströmen der Upwind-Matrix:
+      Fester Rand 0, Dirichlet, Neumann und Dynamisch nur Zufluss (u der
+      Geisterzelle), Outlet nur Abfluss (u der Randzelle), PBC linear über
+      den Rand. Verlässt die Charakteristik das Gebiet über einen Zuflussrand,
+      wird die restliche Zeit als Zuflussdauer gespeichert. */
+
+      int i, j, m;      // Schleifenzähler, Zellfläche, Stück [xN[m],xN[m+1]]
+
+      double L;         // Länge des Gebiets
+      double X, s;      // Position und verbleibende Zeit
+      double uX, un;    // u bei X und am Zielknoten
+      double xn, xm;    // Zielknoten, Knoten m
+      double g;         // Steigung von u auf dem Stück
+      double sn;        // Laufzeit bis zum Zielknoten
+
+      xF[imin-1] = x[imin] - dx[imin]/2.0;
+      for (i=imin;i<=imax;i++) xF[i] = xF[i-1] + dx[i];
+
+      L = xF[imax] - xF[imin-1];
+
+   /* Geschwindigkeit an den Knoten */
+
+      for (i=imin;i<=imax;i++) uN[i] = u[i];
+
+      vW = 0.0;
+      vO = 0.0;
+
+      if ( RBW == DirichletBoundary || RBW == DynamicBoundary || RBW == NeumannBoundary )
+      vW = ( u[imin-1] + fabs(u[imin-1]) )/2.0;
+
+      if ( RBO == DirichletBoundary || RBO == DynamicBoundary || RBO == NeumannBoundary )
+      vO = ( u[imax+1] - fabs(u[imax+1]) )/2.0;
+
+      if ( RBW == OutletBoundary ) vW = ( u[imin] - fabs(u[imin]) )/2.0;
+      if ( RBO == OutletBoundary ) vO = ( u[imax] + fabs(u[imax]) )/2.0;
+
+      if ( RBW == PeriodicBoundary )
+     {
+      vW = u[imax] + ( u[imin] - u[imax] )*( xF[imax] - x[imax] )/( x[imin] + L - x[imax] );
+      vO = vW;
+     }
+
+      uN[imin-1] = vW;
+      uN[imax+1] = vO;
+
+   /* Charakteristiken zurückverfolgen */
+
+      for (j=imin-1;j<=imax;j++)
+     {
+
+      X = xF[j]; s = dt; dK[j] = 0;
+
+      m = j;  // Die Fläche j liegt auf dem Stück zwischen den Knoten j und j+1
+
+      while ( true )
+     {
+
+      xm = ( m == imin-1 ) ? xF[imin-1] : x[m];
+      xn = ( m == imax   ) ? xF[imax  ] : x[m+1];
+      g  = ( uN[m+1] - uN[m] )/( xn - xm );
+      uX = uN[m] + g*( X - xm );
+
+      if ( uX == 0.0 ) break;  // Staupunkt
+
+      if ( uX > 0.0 ) { xn = xm; un = uN[ m ]; }  // Rückwärts nach Westen
+      else            {          un = uN[m+1]; }  // Rückwärts nach Osten
+
+      sn = 0.0;
+
+      if ( un*uX > 0.0 )
+      sn = ( g == 0.0 ) ? ( X - xn )/uX : log1p( g*( X - xn )/un )/g;
+
+      if ( un*uX <= 0.0 || sn >= s )  // Endpunkt auf diesem Stück
+     {
+      X -= ( g == 0.0 ) ? uX*s : -uX*expm1( -g*s )/g;
+      break;
+     }
+
+      s -= sn; X = xn;
+
+      m += ( uX > 0.0 ) ? -1 : 1;
+
+      if ( m < imin-1 || m > imax )  // Über den Rand
+     {
+      if ( RBW == PeriodicBoundary )
+     {
+      if ( m < imin-1 ) { m = imax;   X = xF[imax  ]; dK[j]--; }
+      else              { m = imin-1; X = xF[imin-1]; dK[j]++; }
+      continue;
+     }
+      break;  // Zufluss: X bleibt auf dem Rand, s ist die Zuflussdauer
+     }
+
+     }
+
+   /* Abfahrtszelle und Abstand zu ihrer Westseite */
+
+      if ( m < imin-1 ) { dZ[j] = imin-1; dA[j] = s; continue; }
+      if ( m > imax   ) { dZ[j] = imax+1; dA[j] = s; continue; }
+
+      i = ( m < imin ) ? imin : m;
+      if ( i < imax && X >= xF[i] ) i++;
+
+      dZ[j] = i;
+      dA[j] = X - xF[i-1];
+      if ( dA[j] < 0.0   ) dA[j] = 0.0;
+      if ( dA[j] > dx[i] ) dA[j] = dx[i];
+
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von AbfahrtspunkteBerechnen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von SemiLagrangeZeitschritt
+      ------------------------------------------------------------------ */
+
+      void Kontext::SemiLagrangeZeitschritt(void)
+     {
+
+      double pW[5] = { (double)wF, w1, w2, w3, w4 };  // Wie die Parameter der Zusatzfelder
+      double pO[5] = { (double)oF, o1, o2, o3, o4 };
+
+      SemiLagrangeTransport( rho, 1, pW, pO );
+
+   /* Geisterzellen wie bei den Lösern */
+
+      if ( RBW == DynamicBoundary  ) rho[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary  ) rho[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+      if ( RBW == NeumannBoundary  ) SetGradient( rho, imin, dxrhoW );
+      if ( RBO == NeumannBoundary  ) SetGradient( rho, imax, dxrhoO );
+      if ( RBW == PeriodicBoundary ) { rho[imin-1] = rho[imax]; rho[imax+1] = rho[imin]; }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von SemiLagrangeZeitschritt
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von SemiLagrangeTransport
+      ------------------------------------------------------------------ */
+
+      void Kontext::SemiLagrangeTransport(double *q, int K, double *pW, double *pO)
+     {
+
+   /* Konservative Umverteilung: die Masse der Zelle i zur Zeit t ist die
+      Masse von rho^n zwischen den Abfahrtspunkten ihrer beiden Flächen,
+
+           rho_i dx_i = M(Abfahrt Ostseite) - M(Abfahrt Westseite),
+
+      mit der kumulierten Masse M(X) ab dem Westrand. rho^n ist je Zelle
+      linear mit begrenzter Steigung (Begrenzer TV, bei TV = 0 konstant).
+      Bei PBC zählt jeder Umlauf die Gesamtmasse, Zufluss über einen Rand
+      ist |u| mal das Integral des Randwerts über die Zuflussdauer
+      (ZuflussIntegral, Teilintervalle etwa so lang wie der Durchgang
+      durch die Randzelle). q[i*K] ist das Feld, pW und pO enthalten Funktion
+      und Parameter der dynamischen Ränder. Hilfsfelder: rhoR = rho^n,
+      f = kumulierte Masse, fK = Steigung. */
+
+      int i, j, c;      // Schleifenzähler, Zellfläche, Abfahrtszelle
+
+      double Mt;        // Gesamtmasse
+      double MW, MO;    // M an den Abfahrtspunkten der West- und Ostseite
+      double h;         // Abstand zur Westseite der Abfahrtszelle
+
+      bool P;           // Periodische Ränder
+
+      P  = ( RBW == PeriodicBoundary );
+
+      for (i=imin-1;i<=imax+1;i++) rhoR[i] = q[i*K];
+
+   /* Begrenzte Steigungen, ohne PBC in den Randzellen null */
+
+      for (i=imin;i<=imax;i++)
+     {
+      fK[i] = 0.0;
+      if ( TV == NoLimiter || ( !P && ( i == imin || i == imax ) ) ) continue;
+      fK[i] = (this->*Begrenzer)( ( rhoR[i] - rhoR[( i == imin ) ? imax : i-1] )/( x[ i ] - x[i-1] ),
+                         ( rhoR[( i == imax ) ? imin : i+1] - rhoR[i] )/( x[i+1] - x[ i ] ) );
+     }
+
+   /* Kumulierte Masse an den Ostseiten der Zellen */
+
+      f[imin-1] = 0.0;
+      for (i=imin;i<=imax;i++) f[i] = f[i-1] + rhoR[i]*dx[i];
+
+      Mt = f[imax];
+
+   /* Masse je Zelle aus den gespeicherten Abfahrtspunkten */
+
+      MW = 0.0;
+
+      for (j=imin-1;j<=imax;j++)
+     {
+
+      c = dZ[j];
+
+      if ( c == imin-1 )  // Zufluss über den Westrand
+     {
+      MO = - vW*ZuflussIntegral( ( RBW == DynamicBoundary ) ? pW : NULL, rhoR[imin-1], dA[j], 1 + (int)( vW*dA[j]/dx[imin] ) );
+     }
+      else
+      if ( c == imax+1 )  // Zufluss über den Ostrand
+     {
+      MO = Mt - vO*ZuflussIntegral( ( RBO == DynamicBoundary ) ? pO : NULL, rhoR[imax+1], dA[j], 1 - (int)( vO*dA[j]/dx[imax] ) );
+     }
+      else
+     {
+      h  = dA[j];
+      MO = dK[j]*Mt + f[c-1] + rhoR[c]*h + fK[c]*h*( h - dx[c] )/2.0;
+     }
+
+      if ( j >= imin ) q[j*K] = ( MO - MW )/dx[j];
+
+      MW = MO;
+
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von SemiLagrangeTransport
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ZuflussIntegral
+      ------------------------------------------------------------------ */
+
+      double Kontext::ZuflussIntegral(double *p, double rG, double r, int n)
+     {
+
+   /* Integral des Randwerts über die ersten r Zeiteinheiten des Schritts.
+      Dynamischer Rand (p = Funktion und Parameter): Simpson-Regel mit n
+      Teilintervallen, sonst konstant der Wert rG der Geisterzelle zu
+      Beginn des Schritts. */
+
+      int k;          // Schleifenzähler
+
+      double tn, h;   // Zeit zu Beginn des Schritts, Teilintervall
+      double S;       // Summe
+
+      if ( p == NULL ) return rG*r;
+
+      tn = t - dt;
+      h  = r/n;
+      S  = 0.0;
+
+      for (k=0;k<n;k++)
+      S +=       p[4]*(this->*Funktion[(int)p[0]])( ( tn +  k       *h - p[1] )/p[3] ) + p[2]
+         + 4.0*( p[4]*(this->*Funktion[(int)p[0]])( ( tn + (k+0.5)*h - p[1] )/p[3] ) + p[2] )
+         +       p[4]*(this->*Funktion[(int)p[0]])( ( tn + (k+1)  *h - p[1] )/p[3] ) + p[2];
+
+      return S*h/6.0;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ZuflussIntegral
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von AbbruchschrankeBerechnen
+      ------------------------------------------------------------------ */
+
+      void Kontext::AbbruchschrankeBerechnen(void)
+     {
+
+   /* Schranke dS für die inneren Iterationen des nächsten Zeitschritts:
+
+           SK = 0:  dS = delta                (Änderung bzw. Residuum)
+           SK = 1:  dS = delta * max|rho|     (relativ zur Größe des Feldes)
+           SK = 2:  dS = delta * max|rho|     (echtes Residuum, rechte Seite rho)
+           SK = 3:  dS = SKF * Abschneidefehler, mindestens delta
+
+      Der Abschneidefehler des impliziten Euler-Verfahrens ist dt^2/2 rho_tt,
+      geschätzt mit der zweiten Differenz der letzten drei Zeitebenen,
+
+           dt^2/2 rho_tt = gA rho^n - (gA+gC) rho^(n-1) + gC rho^(n-2),
+           gA = dt^2/(dtV (dtV+dtVV)),  gC = dt^2/(dtVV (dtV+dtVV)),
+
+      bei festem dt also gA = gC = 1/2. Bis die Zeitebenen vorliegen, gilt
+      dS = delta. Für BDF2 und das Theta-Verfahren
+      (ZV > 0) gilt diese Schätzung nicht, dort wird wie bei SK = 1
+      verfahren. */
+
+      int i;          // Schleifenzähler
+
+      double m, e;    // max|rho| und geschätzter Abschneidefehler
+      double gA, gC;  // Gewichte der zweiten Differenz
+
+      DV = 0.0;
+      dS = delta;
+
+      if ( SK == RelativeStop || SK == ResidualStop || ( SK == AdaptiveStop && ZV != ImplicitEuler ) )
+     {
+      m = 0.0;
+      for (i=imin;i<=imax;i++) m = ( fabs(rho[i]) > m ) ? fabs(rho[i]) : m;
+      dS = delta*m;
+     }
+
+      if ( SK == AdaptiveStop && nA == 3 && ZV == ImplicitEuler )
+     {
+      gA = 0.5; gC = 0.5;
+      if ( dtV > 0.0 && dtVV > 0.0 )
+     {
+      gA = dt*dt/( dtV*( dtV + dtVV ) );
+      gC = dt*dt/( dtVV*( dtV + dtVV ) );
+     }
+      e = 0.0;
+      for (i=imin;i<=imax;i++)
+     {
+      m = fabs( gA*rhoA[i] - ( gA + gC )*rhoB[i] + gC*rhoC[i] );
+      e = ( m > e ) ? m : e;
+     }
+      if ( SKF*e > dS ) dS = SKF*e;
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von AbbruchschrankeBerechnen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von VorhersageBerechnen
+      ------------------------------------------------------------------ */
+
+      void Kontext::VorhersageBerechnen(void)
+     {
+
+   /* Startwert fS der inneren Iterationen aus den Zeitebenen rhoA = rho^n,
+      rhoB = rho^(n-1), rhoC = rho^(n-2):
+
+           PR = 1:  fS = rho^n + wL (rho^n - rho^(n-1))           (linear)
+           PR = 2:  fS = lA rho^n + lB rho^(n-1) + lC rho^(n-2)   (quadratisch)
+           PR = 3:  fS = rho^n - (A - I) rho^n                    (expliziter
+                    Upwind-Schritt mit denselben Koeffizienten)
+
+      Die Gewichte setzt ExtrapolationWaehlen, bei festem dt sind es 2, -1
+      bzw. 3, -3, 1. Solange zu wenige Zeitebenen vorliegen, wird die
+      Ordnung gesenkt. Der explizite Schritt ist nur für Courant-Zahlen bis
+      1 stabil; in Zellen mit aP > 2 bleibt fS = rho^n. */
+
+      int i;          // Schleifenzähler
+
+      if ( PR == QuadraticPredictor && nA == 3 )
+     {
+      for (i=imin;i<=imax;i++) fS[i] = lA*rhoA[i] + lB*rhoB[i] + lC*rhoC[i];
+     }
+      else if ( PR != UpwindPredictor && nA >= 2 )
+     {
+      for (i=imin;i<=imax;i++) fS[i] = rhoA[i] + wL*( rhoA[i] - rhoB[i] );
+     }
+      else if ( PR == UpwindPredictor )
+     {
+      for (i=imin;i<=imax;i++)
+      fS[i] = ( aP[i] > 2.0 ) ? rho[i]
+            : rho[i] - aW[i]*rho[i-1] - ( aP[i] - 1.0 )*rho[i] - aE[i]*rho[i+1];
+     }
+      else
+     {
+      for (i=imin;i<=imax;i++) fS[i] = rho[i];
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von VorhersageBerechnen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von StartwertSetzen
+      ------------------------------------------------------------------ */
+
+      void Kontext::StartwertSetzen(void)  // Innere Zellen von f aus fS (PR > 0)
+     {
+
+      int i;          // Schleifenzähler
+
+      for (i=imin;i<=imax;i++) f[i] = fS[i];
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von StartwertSetzen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von EinsparungSchaetzen
+      ------------------------------------------------------------------ */
+
+      void Kontext::EinsparungSchaetzen(void)
+     {
+
+   /* Bei linearer Konvergenz senken KS Iterationen den Fehler vom Abstand
+      eP = max|rho^(n+1) - fS| auf etwa DS. Ohne Prädiktor wäre vom Abstand
+      e0 = max|rho^(n+1) - rho^n| aus zu iterieren; das kostet je Faktor
+      dieselbe Zahl Iterationen, also eingespart
+
+           KP = KS * ln(e0/eP) / ln(eP/DS)
+
+      Negativ, wenn der Prädiktor schlechter als rho^n ist. */
+
+      int i;          // Schleifenzähler
+
+      double e0, eP;
+
+      e0 = 0.0; eP = 0.0;
+
+      for (i=imin;i<=imax;i++)
+     {
+      e0 = ( fabs(rho[i]-rhoA[i]) > e0 ) ? fabs(rho[i]-rhoA[i]) : e0;
+      eP = ( fabs(rho[i]-fS[i]  ) > eP ) ? fabs(rho[i]-fS[i]  ) : eP;
+     }
+
+      KP = 0.0;
+
+      if ( KS > 0 && DS > 0.0 && eP > DS && e0 > 0.0 ) KP = KS*log(e0/eP)/log(eP/DS);
+
+      KE += KP;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von EinsparungSchaetzen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von Abbrechen
+      ------------------------------------------------------------------ */
+
+      bool Kontext::Abbrechen(double D)  // true: innere Iteration beenden
+     {
+
+   /* Bei SK = 3 wird der algebraische Fehler aus der Änderung D und der
+      Konvergenzrate q abgeschätzt: Fehler <= D*q/(1-q). Für q wird das
+      Maximum aus der beobachteten Rate D/DV und der Schranke qS des
+      Lösers genommen. Die beobachtete Rate allein ist zu optimistisch:
+      bei Strömung gegen die Iterationsrichtung ändert eine Iteration nur
+      wenige Zellen, D ist klein, der Fehler aber nicht. */
+
+      double q;       // Konvergenzrate
+
+      if ( SK == AdaptiveStop )
+     {
+      q  = ( DV > 0.0 ) ? D/DV : 1.0;
+      if ( qS > q    ) q = qS;
+      if ( q  > 0.99 ) q = 0.99;
+      DV = D;
+      return D*q/(1.0-q) < dS;
+     }
+
+      DV = D;
+
+      return D < dS;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von Abbrechen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von KonvergenzrateSchaetzen
+      ------------------------------------------------------------------ */
+
+      void Kontext::KonvergenzrateSchaetzen(void)
+     {
+
+   /* Schranken der Iterationsmatrix in der Maximumnorm bei diagonal
+      dominanter Matrix: Gauß-Seidel max |aE|/(aP-|aW|), Rot-Schwarz
+      (wie Jacobi) max (|aW|+|aE|)/aP. Mehrgitter und Krylov-Löser
+      verwenden nur die beobachtete Rate (qS = 0). */
+
+      int i;          // Schleifenzähler
+
+      double q;
+
+      qS = 0.0;
+
+      if ( LS == GaussSeidelSolver )
+      for (i=imin;i<=imax;i++)
+     {
+      q  = ( aP[i] > fabs(aW[i]) ) ? fabs(aE[i])/( aP[i] - fabs(aW[i]) ) : 1.0;
+      qS = ( q > qS ) ? q : qS;
+     }
+
+      if ( LS == RedBlackSolver )
+      for (i=imin;i<=imax;i++)
+     {
+      q  = ( fabs(aW[i]) + fabs(aE[i]) )*raP[i];
+      qS = ( q > qS ) ? q : qS;
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von KonvergenzrateSchaetzen
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von ResiduumFeld
+      ------------------------------------------------------------------ */
+
+      double Kontext::ResiduumFeld(void)  // max|rho - A f| des geschlossenen Systems
+     {
+
+   /* Wie in FaktorisierenSTD und FaktorisierenPBC gehen die Geisterzellen
+      bei Neumann und PBC aus f hervor und nicht aus ihrem gespeicherten
+      Wert, den die Gauß-Seidel Kernel erst nach dem Durchlauf setzen.
+      Sonst prüft das Residuum ein System mit festen Geisterzellen. */
+
+      int i;          // Schleifenzähler
+
+      double D, r;
+      double fW, fO;  // Westliche und östliche Geisterzelle
+
+      fW = f[imin-1];
+      fO = f[imax+1];
+
+      if ( RBW == PeriodicBoundary ) { fW = f[imax]; fO = f[imin]; }
+      if ( RBW == NeumannBoundary  ) fW = f[imin] - dxrhoW*( x[imin] - x[imin-1] );
+      if ( RBO == NeumannBoundary  ) fO = f[imax] + dxrhoO*( x[imax+1] - x[imax] );
+
+      r = rho[imin] - aW[imin]*fW - aP[imin]*f[imin] - aE[imin]*f[imin+1];
+      D = fabs(r);
+
+      for (i=imin+1;i<=imax-1;i++)
+     {
+      r = rho[i] - aW[i]*f[i-1] - aP[i]*f[i] - aE[i]*f[i+1];
+      D = ( fabs(r) > D ) ? fabs(r) : D;
+     }
+
+      r = rho[imax] - aW[imax]*f[imax-1] - aP[imax]*f[imax] - aE[imax]*fO;
+      D = ( fabs(r) > D ) ? fabs(r) : D;
+
+      return D;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von ResiduumFeld
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von FaktorisierenSTD
+      ------------------------------------------------------------------ */
+
+      void Kontext::FaktorisierenSTD(void)  // LR-Zerlegung für den Thomas-Algorithmus
+     {
+
+      int i;          // Lokaler Schleifenzähler
+
+      double dW, dO;  // Beitrag der Neumann-Geisterzellen zur Diagonale
+
+   /* Bei NeumannBoundary wird die Geisterzelle über den Gradienten durch
+      die Randzelle ausgedrückt und landet so auf der Hauptdiagonale */
+
+      dW = 0.0; if ( RBW == NeumannBoundary ) dW = aW[imin];
+      dO = 0.0; if ( RBO == NeumannBoundary ) dO = aE[imax];
+
+      rP[imin] = 1.0 / ( aP[imin] + dW );
+      cT[imin] = aE[imin] * rP[imin];
+
+      for (i=imin+1;i<=imax-1;i++)
+     {
+      rP[i] = 1.0 / ( aP[i] - aW[i]*cT[i-1] );
+      cT[i] = aE[i] * rP[i];
+     }
+
+         i  = imax;
+      rP[i] = 1.0 / ( aP[i] + dO - aW[i]*cT[i-1] );
+      cT[i] = 0.0;
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von FaktorisierenSTD
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von FaktorisierenPBC
+      ------------------------------------------------------------------ */
+
+      void Kontext::FaktorisierenPBC(void)  // Zyklisch: Thomas + Sherman-Morrison
+     {
+
+      int i;          // Lokaler Schleifenzähler
+
+      double g;       // Freier Parameter der Zerlegung A = T + u*v^T
+
+   /* Die Eckelemente aW[imin] und aE[imax] koppeln f[imin] mit f[imax].
+      Mit u = (g,0,...,0,aE[imax]) und v = (1,0,...,0,aW[imin]/g) ist
+      A = T + u*v^T, wobei T nur in den Diagonalelementen von A abweicht.
+      Zerlegt wird T, der Vektor z = T^-1 * u wird gleich mit berechnet. */
+
+      g = - aP[imin];
+
+      rP[imin] = 1.0 / ( aP[imin] - g );
+      cT[imin] = aE[imin] * rP[imin];
+      zT[imin] =    g     * rP[imin];
+
+      for (i=imin+1;i<=imax-1;i++)
+     {
+      rP[i] = 1.0 / ( aP[i] - aW[i]*cT[i-1] );
+      cT[i] = aE[i] * rP[i];
+      zT[i] =       - aW[i]*zT[i-1] * rP[i];
+     }
+
+         i  = imax;
+      rP[i] = 1.0 / ( aP[i] - aW[imin]*aE[imax]/g - aW[i]*cT[i-1] );
+      cT[i] = 0.0;
+      zT[i] = ( aE[imax] - aW[i]*zT[i-1] ) * rP[i];
+
+      for (i=imax-1;i>=imin;i--)
+     {
+      zT[i] -= cT[i]*zT[i+1];
+     }
+
+      vZ = aW[imin]/g;
+      zS = 1.0 + zT[imin] + vZ*zT[imax];
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von FaktorisierenPBC
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von FaktorisierenPAR
+      ------------------------------------------------------------------ */
+
+      void Kontext::FaktorisierenPAR(void)  // Partitionierter Thomas-Algorithmus
+     {
+
+   /* Die Zellen werden in nB Blöcke zerlegt. Die letzte Zelle iE[p] eines
+      Blocks ist Schnittstelle (beim STD-Rand nicht im letzten Block), die
+      übrigen Zellen bilden das Blockinnere. Im Blockinneren gilt
+
+           f[i] = y[i] + vS[i]*f(linke Schnittstelle) + wS[i]*f(rechte Schnittstelle)
+
+      mit der Lösung y des entkoppelten Blocks. Die Zerlegung der Blöcke,
+      die Spikes vS, wS und die LR-Zerlegung des reduzierten Systems für
+      die Schnittstellen hängen nur von den Koeffizienten ab. */
+
+      int p, i, j, k, l, r; // Lokale Schleifenzähler und Indizes
+
+      int a, b;             // Erste und letzte Zelle des Blockinneren
+
+      double dW, dO;        // Beitrag der Neumann-Geisterzellen zur Diagonale
+      double h;             // Hilfsgröße
+
+      int PBC = ( RBW == PeriodicBoundary );
+
+      dW = 0.0; if ( RBW == NeumannBoundary ) dW = aW[imin];
+      dO = 0.0; if ( RBO == NeumannBoundary ) dO = aE[imax];
+
+   /* Blockinneres zerlegen und Spikes berechnen */
+
+      #pragma omp parallel for num_threads(NT) private(i,a,b)
+      for (p=0;p<nB;p++)
+     {
+
+      a = iA[p];
+      b = iE[p] - ( p < nR );
+
+      for (i=a;i<=b;i++)
+     {
+      rB[i] = aP[i];
+      if ( i == imin ) rB[i] += dW;
+      if ( i == imax ) rB[i] += dO;
+      if ( i >  a    ) rB[i] -= aW[i]*cB[i-1];
+      rB[i] = 1.0 / rB[i];
+      cB[i] = aE[i] * rB[i];
+     }
+
+   /* Linker Spike: rechte Seite -aW[a] in der ersten Zeile */
+
+      vS[a] = 0.0; if ( p > 0 || PBC ) vS[a] = - aW[a]*rB[a];
+      for (i=a+1;i<=b;i++) vS[i] = - aW[i]*vS[i-1]*rB[i];
+
+   /* Rechter Spike: rechte Seite -aE[b] in der letzten Zeile */
+
+      for (i=a;i< b;i++) wS[i] = 0.0;
+      wS[b] = 0.0; if ( p < nR ) wS[b] = - aE[b]*rB[b];
+
+      for (i=b-1;i>=a;i--)
+     {
+      vS[i] -= cB[i]*vS[i+1];
+      wS[i] -= cB[i]*wS[i+1];
+     }
+
+     }
+
+   /* Reduziertes System für die Schnittstellen aufstellen: Gleichung der
+      Zelle k = iE[p] nach Einsetzen der Nachbarzellen aus den Blöcken */
+
+      for (i=0;i<nR*nR;i++) AR[i] = 0.0;
+
+      for (p=0;p<nR;p++)
+     {
+
+      k = iE[p];
+      l = ( p + nR - 1 ) % nR;  // Linke Schnittstelle des Blocks p
+      j = ( p + 1 ) % nB;       // Rechter Nachbarblock
+      r = j;                    // Rechte Schnittstelle des Nachbarblocks
+
+      AR[p*nR+p] += aP[k];
+
+      if ( p > 0 || PBC ) { AR[p*nR+l] += aW[k]*vS[k-1]; }
+                            AR[p*nR+p] += aW[k]*wS[k-1];
+
+                            AR[p*nR+p] += aE[k]*vS[iA[j]];
+      if ( r < nR )       { AR[p*nR+r] += aE[k]*wS[iA[j]]; }
+
+     }
+
+   /* LR-Zerlegung mit Spaltenpivotsuche (nR ist klein) */
+
+      for (k=0;k<nR;k++)
+     {
+      pR[k] = k;
+      for (i=k+1;i<nR;i++) if ( fabs(AR[i*nR+k]) > fabs(AR[pR[k]*nR+k]) ) pR[k] = i;
+      if ( pR[k] != k ) for (j=0;j<nR;j++) { h = AR[k*nR+j]; AR[k*nR+j] = AR[pR[k]*nR+j]; AR[pR[k]*nR+j] = h; }
+      for (i=k+1;i<nR;i++)
+     {
+      AR[i*nR+k] /= AR[k*nR+k];
+      for (j=k+1;j<nR;j++) AR[i*nR+j] -= AR[i*nR+k]*AR[k*nR+j];
+     }
+     }
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von FaktorisierenPAR
+      ------------------------------------------------------------------ */
+
+
+
+   /* ------------------------------------------------------------------
+      Anfang von DiagnoseBerechnen
+      ------------------------------------------------------------------ */
+
+      void Kontext::DiagnoseBerechnen(void)  // Masse, Ekin und Impuls, bezogen auf CellCenter!
+     {
+
+   /* M, Ek und px in einem Durchlauf ohne Hilfsfeld. Summiert wird in
+      Blöcken zu BD Zellen, die Blocksummen werden in fester Reihenfolge
+      kompensiert (Neumaier) addiert. Das Ergebnis hängt daher nicht von
+      der Anzahl der Threads ab. */
+
+      int i, j, k;    // Schleifenzähler
+      int a, b;       // Erste und letzte Zelle eines Blocks
+
+      double m, e, p; // Teilsummen eines Blocks
+      double r;       // Masse einer Zelle
+
+      double S[3];    // Summen
+      double C[3];    // Kompensationsterme
+      double y;       // Neue Summe
+
+      const double *R = rho, *D = dx, *V = u;  // Lokale Zeiger für die simd-Reduktion
+
+      #pragma omp parallel for num_threads(NT) private(i,a,b,m,e,p,r)
+      for (j=0;j<nD;j++)
+     {
+
+      a = imin + j*BD;
+      b = a + BD - 1; if ( b > imax ) b = imax;
+
+      m = 0.0; e = 0.0; p = 0.0;
+
+      #pragma omp simd reduction(+:m,e,p) private(r)
+      for (i=a;i<=b;i++)
+     {
+      r  = R[i]*D[i];
+      m += r;
+      p += r*V[i];
+      e += r*V[i]*V[i];
+     }
+
+      DB[3*j  ] = m;
+      DB[3*j+1] = 0.5*e;
+      DB[3*j+2] = p;
+
+     }
+
+      for (k=0;k<3;k++) { S[k] = 0.0; C[k] = 0.0; }
+
+      for (j=0;j<nD;j++) for (k=0;k<3;k++)
+     {
+      y = S[k] + DB[3*j+k];
+      if ( fabs(S[k]) >= fabs(DB[3*j+k]) ) C[k] += ( S[k] - y ) + DB[3*j+k];
+      else                                 C[k] += ( DB[3*j+k] - y ) + S[k];
+      S[k] = y;
+     }
+
+      M  = S[0] + C[0];
+      Ek = S[1] + C[1];
+      px = S[2] + C[2];
+
+     }
+
+   /* ------------------------------------------------------------------
+      Ende von DiagnoseBerechnen
+      ------------------------------------------------------------------ */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittGS
+      ----------------------------------------------------------------------- */
+
+      template <int W, int O>  // W = RBW, O = RBO zur Übersetzungszeit
+      void Kontext::ImpliziterZeitschrittGS(void)
+     {
+
+   /* Für jedes Paar (RBW,RBO) wird ein eigener Kernel erzeugt. Alle
+      Abfragen der Randbedingungen sind Konstanten und werden vom Compiler
+      entfernt, die innere Schleife enthält keine Verzweigungen mehr. */
+
+      int i, K ; // Schleifenzähler
+
+      double D, df;
+
+      D = 0.0;
+
+   /* Startlösung für Gauß-Seidel erzeugen */
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      f[i] = rho[i];
+     }
+
+      if ( PR > 0 ) StartwertSetzen();
+
+   /* DynamicBoundary für neuen Zeitschritt auswerten */
+
+      if ( W == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( O == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+      for (K=0;K<IMAX;K++)  // Innere Iterationen
+     {
+
+      D  = 0.0;  // Geisterzellen ohne Defektberechnung (Pragmatismus)
+
+      if ( W == PeriodicBoundary ) f[imin-1] = f[imax];
+      if ( W == NeumannBoundary  ) SetGradient( f, imin, dxrhoW );
+
+   /* Die i-te Gleichung: aW[i]*f[i-1] + aP[i]*f[i] + aE[i]*f[i+1] = rho[i] */
+
+      for (i=imin;i<=imax;i++)
+     {
+      df = ( rho[i] - aW[i]*f[i-1] - aE[i]*f[i+1] ) * raP[i] - f[i];
+      f[i] += df;
+      D  = ( fabs(df) > D ) ? fabs(df) : D;
+     }
+
+      if ( O == PeriodicBoundary ) f[imax+1] = f[imin];
+      if ( O == NeumannBoundary  ) SetGradient( f, imax, dxrhoO );
+
+      if ( SK == ResidualStop ) D = ResiduumFeld();
+
+      if ( Abbrechen(D) ) break;
+
+      DefektSpeichern(D);  // ln-Skala: D = 0 vermeiden, daher nach break
+
+     }
+
+      KS = K + ( K < IMAX );
+      DS = D;
+
+      if ( W == PeriodicBoundary ) f[imin-1] = f[imax];  // Im letzten Durchlauf veraltet
+
+   /* Rückspeichern, bei PBC und Neumann einschließlich der östlichen Geisterzelle */
+
+      for (i=imin-1;i<=imax+( W == PeriodicBoundary || O == NeumannBoundary );i++)
+     {
+      rho[i] = f[i];
+     }
+
+      if (K==IMAX) NMAX++ ;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittGS
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittWF
+      ----------------------------------------------------------------------- */
+
+      template <int W, int O>  // W = RBW, O = RBO zur Übersetzungszeit
+      void Kontext::ImpliziterZeitschrittWF(void)
+     {
+
+   /* Je k = WF Gauß-Seidel Iterationen laufen gemeinsam als schräge
+      Wellenfront durch das Gitter: im Schritt i berechnet Iteration j die
+      Zelle c = i-j. Sie braucht f[c-1] aus Iteration j (im Schritt davor
+      berechnet) und f[c+1] aus Iteration j-1 (im selben Schritt gerade
+      berechnet, aber noch nicht von Iteration j überschrieben). Das
+      Ergebnis ist bitgleich mit k Iterationen von ImpliziterZeitschrittGS.
+      Die Felder werden nur einmal je k Iterationen aus dem Speicher
+      geladen, die Arbeitsmenge ist ein Fenster von k Zellen im L1-Cache,
+      und die k Iterationen sind voneinander unabhängige Rechenketten.
+      Der Defekt wird nach jeweils k Iterationen geprüft. */
+
+      int i, j, k, K; // Schleifenzähler, Iterationen je Wellenfront
+      int c, l, r;    // Zelle, erste und letzte Iteration eines Schritts
+
+      double D, df;
+
+      D = 0.0;
+      k = WF;
+
+   /* Startlösung für Gauß-Seidel erzeugen */
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      f[i] = rho[i];
+     }
+
+      if ( PR > 0 ) StartwertSetzen();
+
+   /* DynamicBoundary für neuen Zeitschritt auswerten */
+
+      if ( W == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( O == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+      for (K=0;K<IMAX;K+=k)  // Innere Iterationen, k auf einmal
+     {
+
+      if ( k > IMAX-K ) k = IMAX-K;
+
+      for (j=0;j<k;j++) DW[j] = 0.0;
+
+      for (i=imin;i<=imax+k-1;i++)
+     {
+
+      l = i - imax; if ( l < 0   ) l = 0;    // Iteration j bearbeitet Zelle i-j
+      r = i - imin; if ( r > k-1 ) r = k-1;
+
+      for (j=l;j<=r;j++)
+     {
+
+         c = i - j;
+
+      if ( W == NeumannBoundary && c == imin ) SetGradient( f, imin, dxrhoW );
+
+      df = ( rho[c] - aW[c]*f[c-1] - aE[c]*f[c+1] ) * raP[c] - f[c];
+      f[c] += df;
+      DW[j] = ( fabs(df) > DW[j] ) ? fabs(df) : DW[j];
+
+      if ( O == NeumannBoundary && c == imax ) SetGradient( f, imax, dxrhoO );  // Wie nach einem GS-Durchlauf
+
+     }
+
+     }
+
+      D = DW[k-1];
+
+      if ( SK == ResidualStop ) D = DW[k-1] = ResiduumFeld();
+
+      for (j=0;j<k;j++) if ( DW[j] >= dS ) DefektSpeichern(DW[j]);
+
+      if ( Abbrechen(D) ) break;
+
+     }
+
+      KS = K + ( K < IMAX )*k;
+      DS = D;
+
+      for (i=imin-1;i<=imax+( O == NeumannBoundary );i++)  // Rückspeichern
+     {
+      rho[i] = f[i];
+     }
+
+      if (K>=IMAX) NMAX++ ;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittWF
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittTDMA
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ImpliziterZeitschrittTDMA(void)  // Direkte Lösung mit dem Thomas-Algorithmus
+     {
+
+      int i ;         // Schleifenzähler
+
+      double bW, bO;  // Beitrag der Geisterzellen zur rechten Seite
+
+   /* Geisterzellen übernehmen, DynamicBoundary für neuen Zeitschritt auswerten */
+
+      f[imin-1] = rho[imin-1];
+      f[imax+1] = rho[imax+1];
+
+      if ( RBW == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+   /* Bekannte Geisterzellen auf die rechte Seite bringen. Bei NeumannBoundary
+      steckt die Geisterzelle bereits in der Zerlegung (FaktorisierenSTD). */
+
+      bW = - aW[imin]*f[imin-1];
+      bO = - aE[imax]*f[imax+1];
+
+      if ( RBW == NeumannBoundary ) bW =   aW[imin]*dxrhoW*( x[imin] - x[imin-1] );
+      if ( RBO == NeumannBoundary ) bO = - aE[imax]*dxrhoO*( x[imax+1] - x[imax] );
+
+   /* Vorwärtseinsetzen mit der gespeicherten Zerlegung */
+
+      f[imin] = ( rho[imin] + bW ) * rP[imin];
+
+      for (i=imin+1;i<=imax-1;i++)
+     {
+      f[i] = ( rho[i] - aW[i]*f[i-1] ) * rP[i];
+     }
+
+         i  = imax;
+      f[i] = ( rho[i] + bO - aW[i]*f[i-1] ) * rP[i];
+
+   /* Rückwärtseinsetzen */
+
+      for (i=imax-1;i>=imin;i--)
+     {
+      f[i] -= cT[i]*f[i+1];
+     }
+
+   /* Neumann-Geisterzellen aus der neuen Lösung setzen */
+
+      if ( RBW == NeumannBoundary ) SetGradient( f, imin, dxrhoW );
+      if ( RBO == NeumannBoundary ) SetGradient( f, imax, dxrhoO );
+
+      for (i=imin-1;i<=imax+1;i++)  // Rückspeichern
+     {
+      rho[i] = f[i];
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittTDMA
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittZYK
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ImpliziterZeitschrittZYK(void)  // Zyklisch tridiagonal: Thomas + Sherman-Morrison
+     {
+
+      int i ;         // Schleifenzähler
+
+      double s;       // Skalierung der Korrektur
+
+   /* T*y = rho mit der gespeicherten Zerlegung lösen (FaktorisierenPBC) */
+
+      f[imin] = rho[imin] * rP[imin];
+
+      for (i=imin+1;i<=imax;i++)
+     {
+      f[i] = ( rho[i] - aW[i]*f[i-1] ) * rP[i];
+     }
+
+      for (i=imax-1;i>=imin;i--)
+     {
+      f[i] -= cT[i]*f[i+1];
+     }
+
+   /* Sherman-Morrison Korrektur: f = y - (v*y)/(1 + v*z) * z */
+
+      s = ( f[imin] + vZ*f[imax] ) / zS;
+
+      for (i=imin;i<=imax;i++)
+     {
+      f[i] -= s*zT[i];
+     }
+
+      f[imin-1] = f[imax];  // Periodische Geisterzellen
+      f[imax+1] = f[imin];
+
+      for (i=imin-1;i<=imax+1;i++)  // Rückspeichern
+     {
+      rho[i] = f[i];
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittZYK
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittPAR
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ImpliziterZeitschrittPAR(void)  // Partitionierter Thomas-Algorithmus
+     {
+
+      int p, i, k, l;  // Schleifenzähler und Indizes
+
+      int a, b;        // Erste und letzte Zelle des Blockinneren
+
+      double bW, bO;   // Beitrag der Geisterzellen zur rechten Seite
+      double fL, fR;   // Werte der linken und rechten Schnittstelle
+      double h;        // Hilfsgröße
+
+      int PBC = ( RBW == PeriodicBoundary );
+
+   /* Geisterzellen übernehmen, DynamicBoundary für neuen Zeitschritt auswerten */
+
+      f[imin-1] = rho[imin-1];
+      f[imax+1] = rho[imax+1];
+
+      if ( RBW == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+      bW = - aW[imin]*f[imin-1];
+      bO = - aE[imax]*f[imax+1];
+
+      if ( RBW == NeumannBoundary ) bW =   aW[imin]*dxrhoW*( x[imin] - x[imin-1] );
+      if ( RBO == NeumannBoundary ) bO = - aE[imax]*dxrhoO*( x[imax+1] - x[imax] );
+
+      if ( PBC ) { bW = 0.0; bO = 0.0; }
+
+   /* 1. Entkoppelte Blöcke parallel lösen: f = y */
+
+      #pragma omp parallel for num_threads(NT) private(i,a,b)
+      for (p=0;p<nB;p++)
+     {
+
+      a = iA[p];
+      b = iE[p] - ( p < nR );
+
+      f[a] = rho[a] * rB[a];
+      if ( a == imin ) f[a] += bW * rB[a];
+
+      for (i=a+1;i<=b;i++)
+     {
+      f[i] = ( rho[i] - aW[i]*f[i-1] ) * rB[i];
+     }
+
+      if ( b == imax ) f[b] += bO * rB[b];
+
+      for (i=b-1;i>=a;i--)
+     {
+      f[i] -= cB[i]*f[i+1];
+     }
+
+     }
+
+   /* 2. Reduziertes System für die Schnittstellen seriell lösen */
+
+      for (p=0;p<nR;p++)
+     {
+      k     = iE[p];
+      bR[p] = rho[k] - aW[k]*f[k-1] - aE[k]*f[iA[(p+1)%nB]];
+     }
+
+      for (k=0;k<nR;k++)
+     {
+      if ( pR[k] != k ) { h = bR[k]; bR[k] = bR[pR[k]]; bR[pR[k]] = h; }
+      for (i=k+1;i<nR;i++) bR[i] -= AR[i*nR+k]*bR[k];
+     }
+
+      for (k=nR-1;k>=0;k--)
+     {
+      for (i=k+1;i<nR;i++) bR[k] -= AR[k*nR+i]*bR[i];
+      bR[k] /= AR[k*nR+k];
+     }
+
+   /* 3. Blöcke mit den Schnittstellenwerten korrigieren und rückspeichern */
+
+      #pragma omp parallel for num_threads(NT) private(i,a,b,l,fL,fR)
+      for (p=0;p<nB;p++)
+     {
+
+      a = iA[p];
+      b = iE[p] - ( p < nR );
+
+      l  = ( p + nR - 1 ) % ( nR > 0 ? nR : 1 );
+      fL = 0.0; if ( p > 0 || PBC ) fL = bR[l];
+      fR = 0.0; if ( p < nR       ) fR = bR[p];
+
+      for (i=a;i<=b;i++)
+     {
+        f[i] += vS[i]*fL + wS[i]*fR;
+      rho[i]  = f[i];
+     }
+
+      if ( p < nR ) { f[iE[p]] = fR; rho[iE[p]] = fR; }
+
+     }
+
+   /* Geisterzellen setzen */
+
+      if ( PBC )
+     {
+      f[imin-1] = f[imax];
+      f[imax+1] = f[imin];
+     }
+
+      if ( RBW == NeumannBoundary ) SetGradient( f, imin, dxrhoW );
+      if ( RBO == NeumannBoundary ) SetGradient( f, imax, dxrhoO );
+
+      rho[imin-1] = f[imin-1];
+      rho[imax+1] = f[imax+1];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittPAR
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von RelaxationSchaetzen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::RelaxationSchaetzen(void)
+     {
+
+   /* Die Jacobi-Matrix J = -D^-1 (L+U) einer Tridiagonalmatrix mit
+      aW[i+1]*aE[i] >= 0 ist ähnlich zur symmetrischen Matrix S mit den
+      Nebendiagonalen s[i] = sqrt( aE[i]*aW[i+1] ) / sqrt( aP[i]*aP[i+1] ).
+      Der Spektralradius rJ wird mit der Potenzmethode für S geschätzt
+      (von unten, damit ist wR nie zu groß). Rot-Schwarz ist konsistent
+      geordnet, daher gilt wR = 2 / ( 1 + sqrt(1-rJ^2) ). Hilfsfelder sind
+      die des partitionierten Lösers (rB, cB, wS), der hier nicht läuft. */
+
+      int i, K;       // Schleifenzähler
+
+      double *v, *w;  // Iterierte der Potenzmethode
+      double *s;      // Nebendiagonale von S
+      double  q, r;   // Normen und neue Schätzung
+
+      bool PBC;       // Kopplung über den Rand
+
+      v = rB; w = cB; s = wS;
+
+      PBC = ( RBW == PeriodicBoundary );
+
+      for (i=imin;i<imax;i++) s[i] = sqrt( aE[i]*aW[i+1]*raP[i]*raP[i+1] );
+
+      s[imax] = 0.0;
+      if ( PBC ) s[imax] = sqrt( aE[imax]*aW[imin]*raP[imax]*raP[imin] );
+
+      for (i=imin;i<=imax;i++) v[i] = 1.0;
+
+      q  = imax;
+      rJ = 0.0;
+
+      for (K=0;K<200;K++)
+     {
+
+      w[imin] = s[imin]*v[imin+1] + s[imax]*v[imax];
+
+      for (i=imin+1;i<imax;i++) w[i] = s[i-1]*v[i-1] + s[i]*v[i+1];
+
+      w[imax] = s[imax-1]*v[imax-1] + s[imax]*v[imin];
+
+      r = 0.0;
+      for (i=imin;i<=imax;i++) r += w[i]*w[i];
+
+      if ( r == 0.0 ) { rJ = 0.0; break; }   // J nilpotent, z.B. u ohne Vorzeichenwechsel
+
+      r = sqrt(r/q);
+      q = 0.0;
+
+      for (i=imin;i<=imax;i++) { v[i] = w[i]/r; q += v[i]*v[i]; }
+
+      if ( fabs(r-rJ) < 1.0E-6*r ) { rJ = r; break; }
+
+      rJ = r;
+
+     }
+
+      if ( rJ > 0.9999 ) rJ = 0.9999;
+
+      wR = 2.0 / ( 1.0 + sqrt( 1.0 - rJ*rJ ) );
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von RelaxationSchaetzen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittRB
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ImpliziterZeitschrittRB(void)  // Rot-Schwarz SOR
+     {
+
+   /* Erst alle ungeraden (rot), dann alle geraden Zellen (schwarz). Jede
+      Halbiteration hängt nur von der anderen Farbe ab, daher lassen sich
+      beide Schleifen vektorisieren und auf NT Threads verteilen. */
+
+      int i, K, c;    // Schleifenzähler, Farbe
+
+      double D, df;
+
+      D = 0.0;
+
+   /* Startlösung erzeugen, DynamicBoundary für neuen Zeitschritt auswerten */
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      f[i] = rho[i];
+     }
+
+      if ( PR > 0 ) StartwertSetzen();
+
+      if ( RBW == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+      for (K=0;K<IMAX;K++)  // Innere Iterationen
+     {
+
+      D = 0.0;
+
+      for (c=0;c<2;c++)
+     {
+
+      if ( RBW == PeriodicBoundary ) { f[imin-1] = f[imax]; f[imax+1] = f[imin]; }
+      if ( RBW == NeumannBoundary  ) SetGradient( f, imin, dxrhoW );
+      if ( RBO == NeumannBoundary  ) SetGradient( f, imax, dxrhoO );
+
+      #pragma omp parallel for simd num_threads(NT) private(df) reduction(max:D)
+      for (i=imin+c;i<=imax;i+=2)
+     {
+      df = wR * ( ( rho[i] - aW[i]*f[i-1] - aE[i]*f[i+1] ) * raP[i] - f[i] );
+      f[i] += df;
+      D  = ( fabs(df) > D ) ? fabs(df) : D;
+     }
+
+     }
+
+      if ( SK == ResidualStop ) D = ResiduumFeld();
+
+      if ( Abbrechen(D) ) break;
+
+      DefektSpeichern(D);
+
+     }
+
+      KS = K + ( K < IMAX );
+      DS = D;
+
+   /* Geisterzellen zur neuen Lösung passend setzen und rückspeichern */
+
+      if ( RBW == PeriodicBoundary ) { f[imin-1] = f[imax]; f[imax+1] = f[imin]; }
+      if ( RBW == NeumannBoundary  ) SetGradient( f, imin, dxrhoW );
+      if ( RBO == NeumannBoundary  ) SetGradient( f, imax, dxrhoO );
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      rho[i] = f[i];
+     }
+
+      if (K==IMAX) NMAX++ ;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittRB
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von MehrgitterAnlegen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::MehrgitterAnlegen(void)
+     {
+
+   /* Je zwei benachbarte Zellen werden zu einer groben Zelle
+      zusammengefasst (bei ungerader Anzahl bleibt die letzte allein),
+      bis höchstens MGN Zellen übrig sind. Die Ebenen liegen
+      hintereinander in den Feldern gW, gP, ..., Ebene l ab oL[l]. */
+
+      int l, n, o;    // Ebene, Zellen, Anfang
+
+      nM = 1;
+      for (n=imax;n>MGN;n=(n+1)/2) nM++;
+
+      nL = new int[nM];
+      oL = new int[nM];
+
+      o = 0;
+      n = imax;
+
+      for (l=0;l<nM;l++)
+     {
+      nL[l] = n;
+      oL[l] = o;
+      o    += n + 2;
+      n     = ( n + 1 ) / 2;
+     }
+
+      gW = new double[o]; gP = new double[o]; gE = new double[o]; gQ = new double[o];
+      gU = new double[o]; gB = new double[o]; gR = new double[o];
+
+      for (l=0;l<o;l++) { gU[l] = 0.0; gR[l] = 0.0; }
+
+      n  = nL[nM-1];
+      gA = new double[n*n];
+      gp = new int   [n];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von MehrgitterAnlegen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von MehrgitterAufbauen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::MehrgitterAufbauen(void)
+     {
+
+   /* Feinstes Gitter: Matrix ohne Geisterzellen. Bekannte Geisterzellen
+      stehen später auf der rechten Seite, Neumann-Geisterzellen werden wie
+      in FaktorisierenSTD in die Diagonale gezogen, bei PBC bleiben aW[imin]
+      und aE[imax] als Kopplung über den Rand stehen.
+
+      Grobe Gitter: Galerkin-Operator R A P mit stückweise konstanter
+      Prolongation P und summierender Restriktion R = P^T. Für die Zellen
+      a, a+1 einer groben Zelle heißt das: Flüsse zwischen a und a+1
+      heben sich in der Masse auf und gehen in die Diagonale, die äußeren
+      Upwind-Kopplungen bleiben unverändert. Die groben Matrizen bleiben
+      damit Upwind-Matrizen (M-Matrizen), unabhängig von der Streckung
+      des Gitters. */
+
+      int i, j, k, l, n;   // Schleifenzähler, Zellen
+
+      double *W, *P, *E, *Q, *w, *p, *e;
+      double h;
+
+      bool PBC;
+
+      PBC = ( RBW == PeriodicBoundary );
+
+      W = gW + oL[0]; P = gP + oL[0]; E = gE + oL[0]; Q = gQ + oL[0];
+      n = nL[0];
+
+      for (i=1;i<=n;i++)
+     {
+      W[i] = aW[imin-1+i];
+      P[i] = aP[imin-1+i];
+      E[i] = aE[imin-1+i];
+     }
+
+      if ( !PBC )
+     {
+      if ( RBW == NeumannBoundary ) P[1] += W[1];
+      if ( RBO == NeumannBoundary ) P[n] += E[n];
+      W[1] = 0.0;
+      E[n] = 0.0;
+     }
+
+      for (i=1;i<=n;i++) Q[i] = 1.0/P[i];
+
+      for (l=1;l<nM;l++)
+     {
+
+      w = gW + oL[l-1]; p = gP + oL[l-1]; e = gE + oL[l-1];
+      W = gW + oL[l  ]; P = gP + oL[l  ]; E = gE + oL[l  ]; Q = gQ + oL[l];
+
+      n = nL[l-1];
+
+      for (i=1;i<=nL[l];i++)
+     {
+      k = 2*i - 1;
+      if ( k < n ) { W[i] = w[k]; P[i] = p[k] + e[k] + w[k+1] + p[k+1]; E[i] = e[k+1]; }
+      else         { W[i] = w[k]; P[i] = p[k];                          E[i] = e[k  ]; }
+      Q[i] = 1.0/P[i];
+     }
+
+     }
+
+   /* Gröbstes Gitter: dichte Matrix, bei PBC mit Kopplung über den Rand,
+      LR-Zerlegung mit Spaltenpivotsuche */
+
+      l = nM - 1;
+      n = nL[l];
+
+      W = gW + oL[l]; P = gP + oL[l]; E = gE + oL[l];
+
+      for (i=0;i<n*n;i++) gA[i] = 0.0;
+
+      for (i=0;i<n;i++)
+     {
+      gA[i*n+ i         ] += P[i+1];
+      gA[i*n+(i+n-1)%n  ] += W[i+1];
+      gA[i*n+(i+1  )%n  ] += E[i+1];
+     }
+
+      for (k=0;k<n;k++)
+     {
+      gp[k] = k;
+      for (i=k+1;i<n;i++) if ( fabs(gA[i*n+k]) > fabs(gA[gp[k]*n+k]) ) gp[k] = i;
+      if ( gp[k] != k ) for (j=0;j<n;j++) { h = gA[k*n+j]; gA[k*n+j] = gA[gp[k]*n+j]; gA[gp[k]*n+j] = h; }
+      for (i=k+1;i<n;i++)
+     {
+      gA[i*n+k] /= gA[k*n+k];
+      for (j=k+1;j<n;j++) gA[i*n+j] -= gA[i*n+k]*gA[k*n+j];
+     }
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von MehrgitterAufbauen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von MehrgitterGlaetten
+      ----------------------------------------------------------------------- */
+
+      void Kontext::MehrgitterGlaetten(int l, int Richtung)
+     {
+
+   /* MGV Gauß-Seidel Iterationen auf Ebene l, vorwärts (Richtung > 0)
+      oder rückwärts. Vor- und Nachglättung laufen in entgegengesetzter
+      Richtung, damit beide Strömungsrichtungen gleich gut geglättet
+      werden. */
+
+      int i, K, n;    // Schleifenzähler, Zellen
+
+      double *W, *E, *Q, *F, *B;
+
+      W = gW + oL[l]; E = gE + oL[l]; Q = gQ + oL[l];
+      F = gU + oL[l]; B = gB + oL[l];
+
+      n = nL[l];
+
+      for (K=0;K<MGV;K++)
+     {
+
+      if ( RBW == PeriodicBoundary ) { F[0] = F[n]; F[n+1] = F[1]; }
+
+      if ( Richtung > 0 ) for (i=1;i<=n;i++) F[i] = ( B[i] - W[i]*F[i-1] - E[i]*F[i+1] ) * Q[i];
+      else                for (i=n;i>=1;i--) F[i] = ( B[i] - W[i]*F[i-1] - E[i]*F[i+1] ) * Q[i];
+
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von MehrgitterGlaetten
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von MehrgitterZyklus
+      ----------------------------------------------------------------------- */
+
+      void Kontext::MehrgitterZyklus(int l, int Typ)  // Typ 0 = V-Zyklus, 1 = F-Zyklus
+     {
+
+      int i, j, k, n; // Schleifenzähler, Zellen
+
+      double *W, *P, *E, *F, *B, *R, *f, *b;
+      double h;
+
+      F = gU + oL[l]; B = gB + oL[l];
+      n = nL[l];
+
+   /* Gröbstes Gitter direkt lösen */
+
+      if ( l == nM-1 )
+     {
+
+      for (i=0;i<n;i++) F[i+1] = B[i+1];
+
+      for (k=0;k<n;k++)
+     {
+      if ( gp[k] != k ) { h = F[k+1]; F[k+1] = F[gp[k]+1]; F[gp[k]+1] = h; }
+      for (i=k+1;i<n;i++) F[i+1] -= gA[i*n+k]*F[k+1];
+     }
+
+      for (k=n-1;k>=0;k--)
+     {
+      for (j=k+1;j<n;j++) F[k+1] -= gA[k*n+j]*F[j+1];
+      F[k+1] /= gA[k*n+k];
+     }
+
+      return;
+
+     }
+
+      W = gW + oL[l]; P = gP + oL[l]; E = gE + oL[l]; R = gR + oL[l];
+
+   /* Vorglätten, Residuum auf das grobe Gitter summieren */
+
+      MehrgitterGlaetten(l,1);
+
+      if ( RBW == PeriodicBoundary ) { F[0] = F[n]; F[n+1] = F[1]; }
+
+      for (i=1;i<=n;i++) R[i] = B[i] - W[i]*F[i-1] - P[i]*F[i] - E[i]*F[i+1];
+
+      f = gU + oL[l+1];
+      b = gB + oL[l+1];
+
+      for (i=1;i<=nL[l+1];i++)
+     {
+      k    = 2*i - 1;
+      b[i] = R[k] + ( k < n ? R[k+1] : 0.0 );
+     }
+
+      for (i=0;i<=nL[l+1]+1;i++) f[i] = 0.0;
+
+   /* Grobgitterkorrektur: V-Zyklus einmal, F-Zyklus erst F, dann V */
+
+      if ( Typ == 1 ) { MehrgitterZyklus(l+1,1); }
+                        MehrgitterZyklus(l+1,0);
+
+   /* Korrektur stückweise konstant prolongieren, nachglätten */
+
+      for (i=1;i<=n;i++) F[i] += f[(i+1)/2];
+
+      MehrgitterGlaetten(l,-1);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von MehrgitterZyklus
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittMG
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ImpliziterZeitschrittMG(void)  // Mehrgitterverfahren
+     {
+
+      int i, K, n;    // Schleifenzähler, Zellen
+
+      double D, df;
+      double bW, bO;  // Beitrag der Geisterzellen zur rechten Seite
+
+      double *F, *B, *W, *P, *E;
+
+      F = gU + oL[0]; B = gB + oL[0];
+      n = nL[0];
+
+      D = 0.0;
+
+   /* Geisterzellen übernehmen, DynamicBoundary für neuen Zeitschritt auswerten */
+
+      f[imin-1] = rho[imin-1];
+      f[imax+1] = rho[imax+1];
+
+      if ( RBW == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+   /* Rechte Seite wie in ImpliziterZeitschrittTDMA, Startlösung rho bzw. fS */
+
+      bW = - aW[imin]*f[imin-1];
+      bO = - aE[imax]*f[imax+1];
+
+      if ( RBW == NeumannBoundary ) bW =   aW[imin]*dxrhoW*( x[imin] - x[imin-1] );
+      if ( RBO == NeumannBoundary ) bO = - aE[imax]*dxrhoO*( x[imax+1] - x[imax] );
+
+      if ( RBW == PeriodicBoundary ) { bW = 0.0; bO = 0.0; }
+
+      for (i=1;i<=n;i++)
+     {
+      B[i] = rho[imin-1+i];
+      F[i] = rho[imin-1+i];
+     }
+
+      if ( PR > 0 ) for (i=1;i<=n;i++) F[i] = fS[imin-1+i];
+
+      B[1] += bW;
+      B[n] += bO;
+
+      for (i=1;i<=n;i++) f[imin-1+i] = F[i];  // Startlösung: erste Änderung gegen F, nicht gegen alten Speicher
+
+      for (K=0;K<IMAX;K++)  // Zyklen
+     {
+
+      MehrgitterZyklus(0,MZ);
+
+      D = 0.0;
+
+      for (i=1;i<=n;i++)
+     {
+      df = F[i] - f[imin-1+i];
+      f[imin-1+i] = F[i];
+      D  = ( fabs(df) > D ) ? fabs(df) : D;
+     }
+
+      if ( SK == ResidualStop )  // Residuum auf dem feinsten Gitter
+     {
+      W = gW + oL[0]; P = gP + oL[0]; E = gE + oL[0];
+      if ( RBW == PeriodicBoundary ) { F[0] = F[n]; F[n+1] = F[1]; }
+      D = 0.0;
+      for (i=1;i<=n;i++)
+     {
+      df = B[i] - W[i]*F[i-1] - P[i]*F[i] - E[i]*F[i+1];
+      D  = ( fabs(df) > D ) ? fabs(df) : D;
+     }
+     }
+
+      if ( Abbrechen(D) ) break;
+
+      DefektSpeichern(D);
+
+     }
+
+      KS = K + ( K < IMAX );
+      DS = D;
+
+   /* Geisterzellen zur neuen Lösung passend setzen und rückspeichern */
+
+      if ( RBW == PeriodicBoundary ) { f[imin-1] = f[imax]; f[imax+1] = f[imin]; }
+      if ( RBW == NeumannBoundary  ) SetGradient( f, imin, dxrhoW );
+      if ( RBO == NeumannBoundary  ) SetGradient( f, imax, dxrhoO );
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      rho[i] = f[i];
+     }
+
+      if (K==IMAX) NMAX++ ;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittMG
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von KrylovAnlegen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::KrylovAnlegen(void)
+     {
+
+   /* Alle Vektoren haben die Indizes imin..imax wie rho. BiCGSTAB braucht
+      8 Hilfsvektoren, GMRES KM+2 (Basis und ein Arbeitsvektor). */
+
+      int n;          // Anzahl der Hilfsvektoren
+
+      n  = ( KM + 2 > 8 ) ? KM + 2 : 8;
+
+      kB = new double[imax+2];
+      kD = new double[imax+2];
+      kL = new double[imax+2];
+      kU = new double[imax+2];
+      kV = new double[n*(imax+2)];
+      kH = new double[(KM+1)*KM + 3*(KM+1)];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von KrylovAnlegen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von KrylovAufbauen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::KrylovAufbauen(void)
+     {
+
+   /* Der Operator ist A = (aW,aP,aE) auf imin..imax. Neumann-Geisterzellen
+      gehen wie in FaktorisierenSTD in die Diagonale (dWK, dOK), bei PBC
+      koppeln aW[imin] und aE[imax] über den Rand (Ecken der Matrix).
+
+      ILU(0) behält genau diese Besetzung. Ohne PBC ist das die exakte
+      LR-Zerlegung, mit PBC entfallen nur die Auffüllungen in Zeile imax
+      und Spalte imax; die Ecke aE[imax] liefert den Multiplikator kN. */
+
+      int i;          // Schleifenzähler
+
+      bool PBC;
+
+      PBC = ( RBW == PeriodicBoundary );
+
+      dWK = 0.0; if ( RBW == NeumannBoundary ) dWK = aW[imin];
+      dOK = 0.0; if ( RBO == NeumannBoundary ) dOK = aE[imax];
+
+      for (i=imin;i<=imax;i++) kD[i] = 1.0/aP[i];
+
+      kD[imin] = 1.0/( aP[imin] + dWK );
+      kD[imax] = 1.0/( aP[imax] + dOK );
+
+      kU[imin] = kD[imin];
+      kL[imin] = 0.0;
+
+      for (i=imin+1;i<=imax;i++)
+     {
+      kL[i] = aW[i]*kU[i-1];
+      kU[i] = 1.0/( aP[i] - kL[i]*aE[i-1] );
+     }
+
+      kU[imax] = 1.0/( 1.0/kU[imax] + dOK );
+
+      kN = 0.0;
+
+      if ( PBC )
+     {
+      kN       = aE[imax]*kU[imin];
+      kU[imax] = 1.0/( 1.0/kU[imax] - kN*aW[imin] );
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von KrylovAufbauen
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von OperatorAnwenden
+      ----------------------------------------------------------------------- */
+
+      void Kontext::OperatorAnwenden(double *v, double *w)  // w = A v
+     {
+
+      int i;          // Schleifenzähler
+
+      double cW, cO;  // Ecken der Matrix bei PBC
+
+      cW = 0.0; cO = 0.0;
+
+      if ( RBW == PeriodicBoundary ) { cW = aW[imin]; cO = aE[imax]; }
+
+      #pragma omp simd
+      for (i=imin+1;i<=imax-1;i++) w[i] = aW[i]*v[i-1] + aP[i]*v[i] + aE[i]*v[i+1];
+
+      w[imin] = ( aP[imin] + dWK )*v[imin] + aE[imin]*v[imin+1] + cW*v[imax];
+      w[imax] = ( aP[imax] + dOK )*v[imax] + aW[imax]*v[imax-1] + cO*v[imin];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von OperatorAnwenden
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von Skalarprodukt
+      ----------------------------------------------------------------------- */
+
+      double Kontext::Skalarprodukt(double *a, double *b)
+     {
+
+      int i;          // Schleifenzähler
+
+      double s;
+
+      s = 0.0;
+
+      #pragma omp simd reduction(+:s)
+      for (i=imin;i<=imax;i++) s += a[i]*b[i];
+
+      return s;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von Skalarprodukt
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von Residuum
+      ----------------------------------------------------------------------- */
+
+      double Kontext::Residuum(double *v, double *b, double *r)  // r = b - A v, Maximumnorm
+     {
+
+      int i;          // Schleifenzähler
+
+      double D;
+
+      OperatorAnwenden(v,r);
+
+      D = 0.0;
+
+      for (i=imin;i<=imax;i++)
+     {
+      r[i] = b[i] - r[i];
+      D    = ( fabs(r[i]) > D ) ? fabs(r[i]) : D;
+     }
+
+      return D;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von Residuum
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von VorkonditionierenOhne
+      ----------------------------------------------------------------------- */
+
+      void Kontext::VorkonditionierenOhne(double *r, double *z)  // z = r
+     {
+
+      int i;          // Schleifenzähler
+
+      for (i=imin;i<=imax;i++) z[i] = r[i];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von VorkonditionierenOhne
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von VorkonditionierenJAC
+      ----------------------------------------------------------------------- */
+
+      void Kontext::VorkonditionierenJAC(double *r, double *z)  // z = D^-1 r
+     {
+
+      int i;          // Schleifenzähler
+
+      #pragma omp simd
+      for (i=imin;i<=imax;i++) z[i] = r[i]*kD[i];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von VorkonditionierenJAC
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von VorkonditionierenILU
+      ----------------------------------------------------------------------- */
+
+      void Kontext::VorkonditionierenILU(double *r, double *z)  // z = (LU)^-1 r
+     {
+
+      int i;          // Schleifenzähler
+
+   /* Vorwärtseinsetzen L y = r (y in z), bei PBC mit der Ecke kN */
+
+      z[imin] = r[imin];
+
+      for (i=imin+1;i<=imax;i++) z[i] = r[i] - kL[i]*z[i-1];
+
+      z[imax] -= kN*z[imin];
+
+   /* Rückwärtseinsetzen U z = y, bei PBC mit der Ecke aW[imin] in Zeile imin */
+
+      z[imax] *= kU[imax];
+
+      for (i=imax-1;i>imin;i--) z[i] = ( z[i] - aE[i]*z[i+1] ) * kU[i];
+
+      z[imin] = ( z[imin] - aE[imin]*z[imin+1] - ( RBW == PeriodicBoundary ? aW[imin]*z[imax] : 0.0 ) ) * kU[imin];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von VorkonditionierenILU
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von KrylovBiCGSTAB
+      ----------------------------------------------------------------------- */
+
+      void Kontext::KrylovBiCGSTAB(void)  // Rechts vorkonditioniertes BiCGSTAB
+     {
+
+   /* Löst A f = kB mit Startwert f. Abbruch, wenn die Maximumnorm des
+      Residuums kleiner als die Schranke dS ist; KS zählt die Iterationen. */
+
+      int i, K;       // Schleifenzähler
+
+      double *r, *r0, *p, *v, *q, *t, *ph, *qh;
+      double r1, r2, a, w, b, D;
+
+      r  = kV         ; r0 = kV+  (imax+2); p  = kV+2*(imax+2); v  = kV+3*(imax+2);
+      q  = kV+4*(imax+2); t  = kV+5*(imax+2); ph = kV+6*(imax+2); qh = kV+7*(imax+2);
+
+      D  = Residuum(f,kB,r);
+
+      for (i=imin;i<=imax;i++) { r0[i] = r[i]; p[i] = 0.0; v[i] = 0.0; }
+
+      r1 = 1.0; a = 1.0; w = 1.0;
+
+      for (K=0;K<IMAX;K++)
+     {
+
+      if ( D < dS ) break;
+
+      r2 = Skalarprodukt(r0,r);
+      if ( r2 == 0.0 ) { D = Residuum(f,kB,r); r1 = 1.0; a = 1.0; w = 1.0;   // Neustart nach Zusammenbruch
+                         for (i=imin;i<=imax;i++) { r0[i] = r[i]; p[i] = 0.0; v[i] = 0.0; }
+                         r2 = Skalarprodukt(r0,r); if ( r2 == 0.0 ) break; }
+
+      b = ( r2/r1 )*( a/w );
+
+      for (i=imin;i<=imax;i++) p[i] = r[i] + b*( p[i] - w*v[i] );
+
+      (this->*Vorkonditionieren)(p,ph);
+      OperatorAnwenden(ph,v);
+
+      a = r2/Skalarprodukt(r0,v);
+
+      for (i=imin;i<=imax;i++) q[i] = r[i] - a*v[i];
+
+      (this->*Vorkonditionieren)(q,qh);
+      OperatorAnwenden(qh,t);
+
+      w = Skalarprodukt(t,t);
+      w = ( w > 0.0 ) ? Skalarprodukt(t,q)/w : 0.0;
+
+      D = 0.0;
+
+      for (i=imin;i<=imax;i++)
+     {
+      f[i] += a*ph[i] + w*qh[i];
+      r[i]  = q[i] - w*t[i];
+      D     = ( fabs(r[i]) > D ) ? fabs(r[i]) : D;
+     }
+
+      r1 = r2;
+
+      if ( D >= dS ) DefektSpeichern(D);
+
+     }
+
+      KS = K;
+      DS = D;
+
+      if ( D >= dS ) NMAX++ ;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von KrylovBiCGSTAB
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von KrylovGMRES
+      ----------------------------------------------------------------------- */
+
+      void Kontext::KrylovGMRES(void)  // Rechts vorkonditioniertes GMRES mit Neustart nach KM Schritten
+     {
+
+   /* Löst A f = kB mit Startwert f. Die Basis V liegt in kV, dahinter ein
+      Arbeitsvektor z. Die Hessenberg-Matrix wird mit Givens-Rotationen
+      auf Dreiecksform gebracht, |g[j+1]| ist dann die 2-Norm des
+      Residuums (obere Schranke der Maximumnorm). */
+
+      int i, j, l, m, K;   // Schleifenzähler
+
+      double *V, *z, *H, *c, *s, *g;
+      double D, h, e;
+
+      V = kV;
+      z = kV + (KM+1)*(imax+2);
+      H = kH;                 // H[l*KM+j], l = 0..KM
+      c = kH + (KM+1)*KM;
+      s = c  + (KM+1);
+      g = s  + (KM+1);
+
+      K = 0;
+      D = Residuum(f,kB,V);
+
+      while ( D >= dS && K < IMAX )
+     {
+
+      h = sqrt( Skalarprodukt(V,V) );
+
+      for (i=imin;i<=imax;i++) V[i] /= h;
+
+      g[0] = h;
+
+      for (j=0;j<KM && K<IMAX;j++)
+     {
+
+      K++;
+
+      (this->*Vorkonditionieren)(V+j*(imax+2),z);
+      OperatorAnwenden(z,V+(j+1)*(imax+2));
+
+      for (l=0;l<=j;l++)  // Modifiziertes Gram-Schmidt
+     {
+      H[l*KM+j] = Skalarprodukt(V+(j+1)*(imax+2),V+l*(imax+2));
+      for (i=imin;i<=imax;i++) V[(j+1)*(imax+2)+i] -= H[l*KM+j]*V[l*(imax+2)+i];
+     }
+
+      h = sqrt( Skalarprodukt(V+(j+1)*(imax+2),V+(j+1)*(imax+2)) );
+
+      H[(j+1)*KM+j] = h;
+
+      if ( h > 0.0 ) for (i=imin;i<=imax;i++) V[(j+1)*(imax+2)+i] /= h;
+
+      for (l=0;l<j;l++)  // Bisherige Rotationen anwenden
+     {
+      e             =   c[l]*H[l*KM+j] + s[l]*H[(l+1)*KM+j];
+      H[(l+1)*KM+j] = - s[l]*H[l*KM+j] + c[l]*H[(l+1)*KM+j];
+      H[l*KM+j]     =   e;
+     }
+
+      e    = sqrt( H[j*KM+j]*H[j*KM+j] + h*h );
+      c[j] = H[j*KM+j]/e;
+      s[j] = h/e;
+
+      H[j*KM+j]     = e;
+      H[(j+1)*KM+j] = 0.0;
+
+      g[j+1] = - s[j]*g[j];
+      g[j]   =   c[j]*g[j];
+
+      if ( fabs(g[j+1]) < dS ) { j++; break; }
+
+      DefektSpeichern(fabs(g[j+1]));
+
+     }
+
+      m = j;
+
+   /* Dreieckssystem lösen (y in g), f += M^-1 V y */
+
+      for (l=m-1;l>=0;l--)
+     {
+      for (i=l+1;i<m;i++) g[l] -= H[l*KM+i]*g[i];
+      g[l] /= H[l*KM+l];
+     }
+
+      for (i=imin;i<=imax;i++) V[(KM)*(imax+2)+i] = 0.0;
+
+      for (l=0;l<m;l++) for (i=imin;i<=imax;i++) V[KM*(imax+2)+i] += g[l]*V[l*(imax+2)+i];
+
+      (this->*Vorkonditionieren)(V+KM*(imax+2),z);
+
+      for (i=imin;i<=imax;i++) f[i] += z[i];
+
+      D = Residuum(f,kB,V);  // Neustart mit dem wahren Residuum
+
+     }
+
+      KS = K;
+      DS = D;
+
+      if ( D >= dS ) NMAX++ ;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von KrylovGMRES
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von ImpliziterZeitschrittKRY
+      ----------------------------------------------------------------------- */
+
+      void Kontext::ImpliziterZeitschrittKRY(void)  // Krylov-Löser
+     {
+
+      int i ;         // Schleifenzähler
+
+      double bW, bO;  // Beitrag der Geisterzellen zur rechten Seite
+
+   /* Geisterzellen übernehmen, DynamicBoundary für neuen Zeitschritt auswerten */
+
+      for (i=imin-1;i<=imax+1;i++) f[i] = rho[i];
+
+      if ( PR > 0 ) StartwertSetzen();
+
+      if ( RBW == DynamicBoundary ) f[imin-1] = w4*(this->*W0)( ( t - w1 )/w3 ) + w2;
+      if ( RBO == DynamicBoundary ) f[imax+1] = o4*(this->*O0)( ( t - o1 )/o3 ) + o2;
+
+   /* Rechte Seite wie in ImpliziterZeitschrittTDMA */
+
+      bW = - aW[imin]*f[imin-1];
+      bO = - aE[imax]*f[imax+1];
+
+      if ( RBW == NeumannBoundary ) bW =   aW[imin]*dxrhoW*( x[imin] - x[imin-1] );
+      if ( RBO == NeumannBoundary ) bO = - aE[imax]*dxrhoO*( x[imax+1] - x[imax] );
+
+      if ( RBW == PeriodicBoundary ) { bW = 0.0; bO = 0.0; }
+
+      for (i=imin;i<=imax;i++) kB[i] = rho[i];
+
+      kB[imin] += bW;
+      kB[imax] += bO;
+
+      (this->*KrylovLoeser)();  // Startwert f = rho bzw. fS
+
+   /* Geisterzellen zur neuen Lösung passend setzen und rückspeichern */
+
+      if ( RBW == PeriodicBoundary ) { f[imin-1] = f[imax]; f[imax+1] = f[imin]; }
+      if ( RBW == NeumannBoundary  ) SetGradient( f, imin, dxrhoW );
+      if ( RBO == NeumannBoundary  ) SetGradient( f, imax, dxrhoO );
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      rho[i] = f[i];
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von ImpliziterZeitschrittKRY
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppenVorbereiten
+      ----------------------------------------------------------------------- */
+
+      void Kontext::FeldgruppenVorbereiten(void)
+     {
+
+   /* Neben rho werden nF = EM + NS Zusatzfelder mit demselben u und dt
+      transportiert:
+
+        - EM Ensemble-Mitglieder (Datei ensemble.dat, je Zeile)
+
+             r1 r2 r3 r4 r5 r6 w1 w2 w3 w4 o1 o2 o3 o4
+
+          mit rF, wF, oF, RBW und RBO des Hauptfeldes,
+
+        - NS Skalare mit eigener Anfangsfunktion und eigenen Rändern
+          (Datei skalare.dat, je Zeile)
+
+             rF r1 r2 r3 r4 r5 r6 RBW wF w1 w2 w3 w4 RBO oF o1 o2 o3 o4
+
+      Felder mit gleichen Randbedingungen bilden eine Feldgruppe mit einer
+      gemeinsamen Koeffizientenmatrix. Je Zelle liegen die K Werte einer
+      Gruppe hintereinander, so dass ein Zeitschritt alle Felder der Gruppe
+      in einem Durchlauf löst. Je Feld werden die 19 Parameter in der
+      Reihenfolge von skalare.dat gespeichert. */
+
+      int i, j, k, l;     // Lokale Schleifenzähler
+
+      double *P;          // Parameter aller Zusatzfelder
+      double *q;          // Parameter eines Feldes
+      double *r;          // Feld der Gruppe
+
+      Feldgruppe *G;      // Aktuelle Gruppe
+
+      double (Kontext::*RF)(double), (Kontext::*WF)(double), (Kontext::*OF)(double);  // Funktionen eines Feldes
+
+      ifstream fin;       // Objekt für Dateieingabe
+
+      P  = new double[19*nF];
+      gF = new int   [nF];
+      kF = new int   [nF];
+      mF = new double[nF];
+
+   /* Parameter einlesen */
+
+      fin.open("ensemble.dat");
+      for (j=0;j<EM;j++)
+     {
+      q = P + 19*j;
+      q[ 0] = rF; for (i=1;i<= 6;i++) fin >> q[i];
+      q[ 7] = RBW;
+      q[ 8] = wF; for (i=9;i<=12;i++) fin >> q[i];
+      q[13] = RBO;
+      q[14] = oF; for (i=15;i<=18;i++) fin >> q[i];
+     }
+      if ( EM > 0 && !fin )
+     {
+      *Konsole << "\n >> Fehler: \"ensemble.dat\" fehlt oder enthält zu wenige Zeilen !\n\n";
+      abort();
+     }
+      fin.close();
+
+      fin.open("skalare.dat");
+      for (j=EM;j<nF;j++)
+     {
+      q = P + 19*j;
+      for (i=0;i<19;i++) fin >> q[i];
+      if ( !fin )
+     {
+      *Konsole << "\n >> Fehler: \"skalare.dat\" fehlt oder enthält zu wenige Zeilen !\n\n";
+      abort();
+     }
+      if ( q[ 0] < 0 || q[ 0] > FM || q[ 8] < 0 || q[ 8] > FM || q[14] < 0 || q[14] > FM )
+     {
+      *Konsole << "\n >> Fehler: Unbekannte Funktion rF, wF oder oF in \"skalare.dat\" !\n\n";
+      abort();
+     }
+      if ( q[7] < WallBoundary || q[7] > OutletBoundary || q[13] < WallBoundary || q[13] > OutletBoundary )
+     {
+      *Konsole << "\n >> Fehler: Unbekannte Randbedingung RBW oder RBO in \"skalare.dat\" !\n\n";
+      abort();
+     }
+      if ( q[7] == PeriodicBoundary || q[13] == PeriodicBoundary ) { q[7] = PeriodicBoundary; q[13] = PeriodicBoundary; }
+     }
+      fin.close();
+
+   /* Felder nach Randbedingungen gruppieren */
+
+      FG = new Feldgruppe[nF];
+      nG = 0;
+
+      for (j=0;j<nF;j++)
+     {
+      q = P + 19*j;
+      for (l=0;l<nG;l++) if ( FG[l].RBW == q[7] && FG[l].RBO == q[13] ) break;
+      if ( l == nG ) { FG[l].RBW = (int)q[7]; FG[l].RBO = (int)q[13]; FG[l].K = 0; nG++; }
+      gF[j] = l;
+      kF[j] = FG[l].K++;
+     }
+
+      for (l=0;l<nG;l++)
+     {
+
+      G = FG + l;
+
+      G->rho = new double[(imax+2)*G->K];
+      G->p   = new double[19*G->K];
+      G->g   = new double[ 2*G->K];
+      G->s   = new double[   G->K];
+      G->rV  = new double[(imax+2)*G->K];
+      G->rR  = ( TV != NoLimiter ) ? new double[(imax+2)*G->K] : NULL;
+
+      if ( G->RBW == RBW && G->RBO == RBO )  // Matrix des Hauptfeldes verwenden
+     {
+      G->aW = aW; G->aP = aP; G->aE = aE;
+      G->rP = rP; G->cT = cT; G->zT = zT;
+      G->dZ = dZ; G->dK = dK; G->dA = dA;
+     }
+      else
+     {
+      G->aW = new double[imax+2]; G->aP = new double[imax+2]; G->aE = new double[imax+2];
+      G->rP = new double[imax+2]; G->cT = new double[imax+2]; G->zT = new double[imax+2];
+      G->dZ = NULL; G->dK = NULL; G->dA = NULL;
+      if ( ZV == SemiLagrangeScheme ) { G->dZ = new int[imax+2]; G->dK = new int[imax+2]; G->dA = new double[imax+2]; }
+     }
+
+     }
+
+      for (j=0;j<nF;j++) for (i=0;i<19;i++) FG[gF[j]].p[19*kF[j]+i] = P[19*j+i];
+
+      delete [] P;
+
+   /* Anfangszustand wie beim Hauptfeld */
+
+      if (AZ==0)
      {
 
-      int i;      // Lokaler Schleifenzähler
+      for (j=0;j<nF;j++)
+     {
+
+      G = FG + gF[j]; k = kF[j]; q = G->p + 19*k; r = G->rho;
 
-      double M;   // Lokale Extensive Größe M
+      RF = Funktion[(int)q[0]]; WF = Funktion[(int)q[8]]; OF = Funktion[(int)q[14]];
 
-      M = 0.0;
+      for (i=imin-1;i<=imax+1;i++) r[i*G->K+k] = q[4]*(this->*RF)( ( x[i]-q[1] )/q[3] ) + q[2];
 
-      for (i=imin;i<=imax;i++) M += m[i]*dx[i];
+      r[(imin-1)*G->K+k] += q[5];
+      r[(imax-1)*G->K+k] += q[6];
 
-      return M;
+      if ( G->RBW == DynamicBoundary ) r[(imin-1)*G->K+k] = q[12]*(this->*WF)( ( ta - q[ 9] )/q[11] ) + q[10];
+      if ( G->RBO == DynamicBoundary ) r[(imax+1)*G->K+k] = q[18]*(this->*OF)( ( ta - q[15] )/q[17] ) + q[16];
 
+      if ( G->RBW == PeriodicBoundary )
+     {
+      r[(imin-1)*G->K+k] = r[imax*G->K+k];
+      r[(imax+1)*G->K+k] = r[imin*G->K+k];
      }
 
-   /* ------------------------------------------------------------------
-      Ende von VolumenIntegration
-      ------------------------------------------------------------------ */
+     }
 
+     }
 
+      if (AZ==1)  // Simulation fortsetzen
+     {
+      FelderEinlesen( 0,EM,"rhoE.out","BoundaryE.out");
+      FelderEinlesen(EM,nF,"rhoS.out","BoundaryS.out");
+     }
 
-   /* ------------------------------------------------------------------
-      Anfang von HilfsfelderBerechnenPBC
-      ------------------------------------------------------------------ */
+      if (AZ==2)  // Simulation am Checkpoint fortsetzen
+     {
+      for (j=0;j<nF;j++) for (i=imin-1;i<=imax+1;i++) FG[gF[j]].rho[i*FG[gF[j]].K+kF[j]] = chkF[j*(imax+2)+i];
+     }
 
-      void HilfsfelderBerechnenPBC(void)
+      for (l=0;l<nG;l++)  // Vorherige Zeitebene (ZV = 1), aus dem Checkpoint oder wie rho
      {
+      G = FG + l;
+      for (i=0;i<(imax+2)*G->K;i++) G->rV[i] = G->rho[i];
+     }
 
-      int i;                    // Lokaler Schleifenzähler
+      if (AZ==2) for (j=0;j<nF;j++) for (i=imin-1;i<=imax+1;i++) FG[gF[j]].rV[i*FG[gF[j]].K+kF[j]] = chkV[j*(imax+2)+i];
 
-      for (i=imin;i<=imax;i++)  // Standard für alle Zellen
+   /* Bei NeumannBoundary die ersten Ableitungen speichern */
+
+      for (j=0;j<nF;j++)
      {
-      aW[i] = - ( u[i-1] + fabs(u[i-1]) ) * dt/dx[i]/2.0 ;
-      aP[i] =       1.0  + fabs(u[ i ])   * dt/dx[i]     ;
-      aE[i] =   ( u[i+1] - fabs(u[i+1]) ) * dt/dx[i]/2.0 ;
+      G = FG + gF[j]; k = kF[j]; r = G->rho;
+      G->g[2*k  ] = ( r[ imin   *G->K+k] - r[(imin-1)*G->K+k] ) / ( x[ imin ] - x[imin-1] );
+      G->g[2*k+1] = ( r[(imax+1)*G->K+k] - r[ imax   *G->K+k] ) / ( x[imax+1] - x[ imax ] );
+      if (AZ==2) { G->g[2*k] = chkG[2*j]; G->g[2*k+1] = chkG[2*j+1]; }
      }
 
+   /* Koeffizienten der Gruppen mit eigenen Randbedingungen */
+
+      FeldgruppenKoeffizienten();
 
      }
 
-   /* ------------------------------------------------------------------
-      Ende von HilfsfelderBerechnenPBC
-      ------------------------------------------------------------------ */
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppenVorbereiten
+      ----------------------------------------------------------------------- */
 
 
 
-   /* ------------------------------------------------------------------
-      Anfang von HilfsfelderBerechnenSTD
-      ------------------------------------------------------------------ */
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppenKoeffizienten
+      ----------------------------------------------------------------------- */
 
-      void HilfsfelderBerechnenSTD(void)
+      void Kontext::FeldgruppenKoeffizienten(void)
      {
 
-      int i;                        // Lokaler Schleifenzähler
+   /* Gruppen mit eigenen Randbedingungen verwenden die Routinen des
+      Hauptfeldes. Dazu werden Randbedingungen, Koeffizienten und Zerlegung
+      vorübergehend mit denen der Gruppe vertauscht. */
 
-      for (i=imin+1;i<=imax-1;i++)  // Standard für innere Zellen
+      int l;          // Lokaler Schleifenzähler
+
+      double uW, uO;  // Geisterzellen von u
+
+      Feldgruppe *G;  // Aktuelle Gruppe
+
+      uW = u[imin-1];
+      uO = u[imax+1];
+
+      for (l=0;l<nG;l++)
+     {
+
+      G = FG + l;
+
+      if ( G->aW == aW )  // Gemeinsame Matrix mit dem Hauptfeld
      {
-      aW[i] = - ( u[i-1] + fabs(u[i-1]) ) * dt/dx[i]/2.0 ;
-      aP[i] =       1.0  + fabs(u[ i ])   * dt/dx[i]     ;
-      aE[i] =   ( u[i+1] - fabs(u[i+1]) ) * dt/dx[i]/2.0 ;
+      G->zS = zS; G->vZ = vZ;
+      G->vW = vW; G->vO = vO;
+      continue;
      }
 
-   /* ----------------------------------------------------------------------- */
+      swap(RBW,G->RBW); swap(RBO,G->RBO);
+      swap(aW ,G->aW ); swap(aP ,G->aP ); swap(aE ,G->aE );
+      swap(rP ,G->rP ); swap(cT ,G->cT ); swap(zT ,G->zT );
+      swap(zS ,G->zS ); swap(vZ ,G->vZ );
+      swap(dZ ,G->dZ ); swap(dK ,G->dK ); swap(dA ,G->dA );
+      swap(vW ,G->vW ); swap(vO ,G->vO );
 
-      if ( RBW == WallBoundary )  // Kein Fluss zwischen W und P
+      if ( ZV == SemiLagrangeScheme ) AbfahrtspunkteBerechnen();  // Keine Matrix
+      else
+      if ( RBW == PeriodicBoundary ) { u[imin-1] = u[imax]; u[imax+1] = u[imin];  // u periodisch fortsetzen
+                                       HilfsfelderBerechnenPBC(); FaktorisierenPBC();
+                                       u[imin-1] = uW;      u[imax+1] = uO;     }
+      else                           { HilfsfelderBerechnenSTD(); FaktorisierenSTD(); }
+
+      swap(RBW,G->RBW); swap(RBO,G->RBO);
+      swap(aW ,G->aW ); swap(aP ,G->aP ); swap(aE ,G->aE );
+      swap(rP ,G->rP ); swap(cT ,G->cT ); swap(zT ,G->zT );
+      swap(zS ,G->zS ); swap(vZ ,G->vZ );
+      swap(dZ ,G->dZ ); swap(dK ,G->dK ); swap(dA ,G->dA );
+      swap(vW ,G->vW ); swap(vO ,G->vO );
+
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppenKoeffizienten
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppenZeitschritt
+      ----------------------------------------------------------------------- */
+
+      void Kontext::FeldgruppenZeitschritt(void)  // Alle Felder einer Gruppe in einem Durchlauf
      {
 
-         i  = imin                                            ;
-      aW[i] = 0.0                                             ;
-      aP[i] = 1.0  + ( u[ i ] + fabs(u[ i ]) ) * dt/dx[i]/2.0 ;
-      aE[i] =        ( u[i+1] - fabs(u[i+1]) ) * dt/dx[i]/2.0 ;
-      
+      int l;          // Lokaler Schleifenzähler
+
+      for (l=0;l<nG;l++)
+     {
+
+      if ( ZV != ImplicitEuler ) FeldgruppeRechteSeite(l);
+
+      if      ( ZV == SemiLagrangeScheme ) FeldgruppeSemiLagrange(l);
+      else if ( TV != NoLimiter          ) FeldgruppeKorrektur(l);  // Ruft DK-mal FeldgruppeLoesen
+      else                                 FeldgruppeLoesen(l);
+
      }
 
-      if ( RBO == WallBoundary )  // Kein Fluss zwischen E und P
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppenZeitschritt
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppeLoesen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::FeldgruppeLoesen(int l)  // Löst das System der Gruppe l, rechte Seite in G->rho
      {
 
-         i  = imax                                            ;
-      aW[i] =      - ( u[i-1] + fabs(u[i-1]) ) * dt/dx[i]/2.0 ;
-      aP[i] = 1.0  - ( u[ i ] - fabs(u[ i ]) ) * dt/dx[i]/2.0 ;
-      aE[i] = 0.0  ;
-      
+   /* Thomas-Algorithmus (bzw. Sherman-Morrison bei PBC) mit der
+      gespeicherten Zerlegung der Gruppe. Die innerste Schleife läuft über
+      die K Felder der Gruppe, ist unabhängig und wird vektorisiert. */
+
+      int i, k;       // Lokale Schleifenzähler
+      int K;          // Anzahl der Felder der Gruppe
+
+      double *r;      // Werte der Zelle i
+      double *s;      // Werte der Nachbarzelle
+      double *q;      // Parameter des Feldes k
+
+      double hW, hO;  // Abstand Geisterzelle - Randzelle
+
+      Feldgruppe *G;  // Gruppe l
+
+      hW = x[ imin ] - x[imin-1];
+      hO = x[imax+1] - x[ imax ];
+
+      G = FG + l; K = G->K;
+
+      if ( G->RBW != PeriodicBoundary )
+     {
+
+   /* DynamicBoundary auswerten, Geisterzellen auf die rechte Seite bringen */
+
+      for (k=0;k<K;k++)
+     {
+      q = G->p + 19*k;
+      if ( G->RBW == DynamicBoundary ) G->rho[(imin-1)*K+k] = q[12]*(this->*Funktion[(int)q[ 8]])( ( t - q[ 9] )/q[11] ) + q[10];
+      if ( G->RBO == DynamicBoundary ) G->rho[(imax+1)*K+k] = q[18]*(this->*Funktion[(int)q[14]])( ( t - q[15] )/q[17] ) + q[16];
      }
 
-   /* ----------------------------------------------------------------------- */
+      r = G->rho + imin*K; s = r - K;
 
-      if ( RBW == DirichletBoundary || RBW == DynamicBoundary || RBW == NeumannBoundary )  // Kein Fluss von P nach W
+      for (k=0;k<K;k++)
      {
+      if ( G->RBW == NeumannBoundary ) r[k] += G->aW[imin]*G->g[2*k]*hW;
+      else                             r[k] -= G->aW[imin]*s[k];
+     }
 
-         i  = imin                                            ;
-      aW[i] =      - ( u[i-1] + fabs(u[i-1]) ) * dt/dx[i]/2.0 ;
-      aP[i] = 1.0  + ( u[ i ] + fabs(u[ i ]) ) * dt/dx[i]/2.0 ;
-      aE[i] =        ( u[i+1] - fabs(u[i+1]) ) * dt/dx[i]/2.0 ;
+      r = G->rho + imax*K; s = r + K;
+
+      for (k=0;k<K;k++)
+     {
+      if ( G->RBO == NeumannBoundary ) r[k] -= G->aE[imax]*G->g[2*k+1]*hO;
+      else                             r[k] -= G->aE[imax]*s[k];
+     }
 
      }
 
-      if ( RBO == DirichletBoundary || RBO == DynamicBoundary || RBO == NeumannBoundary )  // Kein Fluss von P nach E
+   /* Vorwärtseinsetzen */
+
+      r = G->rho + imin*K;
+
+      #pragma omp simd
+      for (k=0;k<K;k++) r[k] *= G->rP[imin];
+
+      for (i=imin+1;i<=imax;i++)
      {
+      r = G->rho + i*K; s = r - K;
+      #pragma omp simd
+      for (k=0;k<K;k++) r[k] = ( r[k] - G->aW[i]*s[k] ) * G->rP[i];
+     }
 
-         i  = imax                                            ;
-      aW[i] =      - ( u[i-1] + fabs(u[i-1]) ) * dt/dx[i]/2.0 ;
-      aP[i] = 1.0  - ( u[ i ] - fabs(u[ i ]) ) * dt/dx[i]/2.0 ;
-      aE[i] =        ( u[i+1] - fabs(u[i+1]) ) * dt/dx[i]/2.0 ;
-      
+   /* Rückwärtseinsetzen */
+
+      for (i=imax-1;i>=imin;i--)
+     {
+      r = G->rho + i*K; s = r + K;
+      #pragma omp simd
+      for (k=0;k<K;k++) r[k] -= G->cT[i]*s[k];
      }
 
-   /* ----------------------------------------------------------------------- */
+   /* Geisterzellen */
 
-      if ( RBW == OutletBoundary )     // Kein Fluss von W nach P
+      if ( G->RBW == PeriodicBoundary )  // Sherman-Morrison Korrektur je Feld
      {
 
-          i = imin                                       ;
-      aW[i] =       0.0                                  ;
-      aP[i] =       1.0  + fabs(u[ i ])   * dt/dx[i]     ;
-      aE[i] =   ( u[i+1] - fabs(u[i+1]) ) * dt/dx[i]/2.0 ;
+      for (k=0;k<K;k++) G->s[k] = ( G->rho[imin*K+k] + G->vZ*G->rho[imax*K+k] ) / G->zS;
 
+      for (i=imin;i<=imax;i++)
+     {
+      r = G->rho + i*K;
+      #pragma omp simd
+      for (k=0;k<K;k++) r[k] -= G->s[k]*G->zT[i];
      }
 
-      if ( RBO == OutletBoundary )     // Kein Fluss von E nach P
+      for (k=0;k<K;k++)
      {
-          i = imax                                       ;
-      aW[i] = - ( u[i-1] + fabs(u[i-1]) ) * dt/dx[i]/2.0 ;
-      aP[i] =       1.0  + fabs(u[ i ])   * dt/dx[i]     ;
-      aE[i] =       0.0                                  ;
+      G->rho[(imin-1)*K+k] = G->rho[imax*K+k];
+      G->rho[(imax+1)*K+k] = G->rho[imin*K+k];
+     }
 
      }
 
-   /* ----------------------------------------------------------------------- */
+      for (k=0;k<K;k++)
+     {
+      if ( G->RBW == NeumannBoundary ) G->rho[(imin-1)*K+k] = G->rho[imin*K+k] - G->g[2*k  ]*hW;
+      if ( G->RBO == NeumannBoundary ) G->rho[(imax+1)*K+k] = G->rho[imax*K+k] + G->g[2*k+1]*hO;
+     }
 
      }
 
-   /* ------------------------------------------------------------------
-      Ende von HilfsfelderBerechnenSTD
-      ------------------------------------------------------------------ */
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppeLoesen
+      ----------------------------------------------------------------------- */
 
 
 
-   /* ------------------------------------------------------------------
-      Anfang von MasseBerechnen
-      ------------------------------------------------------------------ */
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppeKorrektur
+      ----------------------------------------------------------------------- */
 
-      void MasseBerechnen(void)
+      void Kontext::FeldgruppeKorrektur(int l)  // Wie KorrekturZeitschritt für Gruppe l
      {
 
-      M = VolumenIntegration(rho);
+   /* rV enthält rho^n: bei BDF2 und Theta aus FeldgruppeRechteSeite, beim
+      Euler-Verfahren wird es hier kopiert. Die Korrektur wird je Feld in
+      fK berechnet und sofort auf dessen rechte Seite angewendet. */
 
-     }
+      int i, j, k;    // Lokale Schleifenzähler
+      int K;          // Anzahl der Felder der Gruppe
 
-   /* ------------------------------------------------------------------
-      Ende von MasseBerechnen
-      ------------------------------------------------------------------ */
+      bool P;         // Periodische Ränder
 
+      double c;       // (1-Theta)/Theta
 
+      Feldgruppe *G;  // Gruppe l
 
-   /* ------------------------------------------------------------------
-      Anfang von EkinBerechnen
-      ------------------------------------------------------------------ */
+      G = FG + l; K = G->K;
+
+      P = ( G->RBW == PeriodicBoundary );
+
+      if ( ZV == ImplicitEuler ) for (i=0;i<(imax+2)*K;i++) G->rV[i] = G->rho[i];
 
-      void EkinBerechnen(void)     // Bezogen auf CellCenter!
+      for (i=imin*K;i<(imax+1)*K;i++) G->rR[i] = G->rho[i];
+
+      for (j=0;j<DK;j++)
      {
 
-      int i;  // Schleifenzähler
+      for (k=0;k<K;k++)
+     {
+
+      KorrekturBerechnen( ( j == 0 ) ? G->rV + k : G->rho + k, K, P );
 
-      for (i=imin;i<=imax;i++) f[i] = 0.5*rho[i]*u[i]*u[i];
+      if ( j == 0 && ZV == ThetaScheme )
+     {
+      c = ( 1.0 - th )/th;
+      for (i=imin;i<=imax;i++) G->rR[i*K+k] -= c*dtdx[i]*( fK[i] - fK[i-1] );
+     }
 
-      Ek = VolumenIntegration(f);
+      for (i=imin;i<=imax;i++) G->rho[i*K+k] = G->rR[i*K+k] - dtdx[i]*( fK[i] - fK[i-1] );
 
      }
 
-   /* ------------------------------------------------------------------
-      Ende von EkinBerechnen
-      ------------------------------------------------------------------ */
+      FeldgruppeLoesen(l);
 
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppeKorrektur
+      ----------------------------------------------------------------------- */
 
 
-   /* ------------------------------------------------------------------
-      Anfang von ImpulsBerechnen
-      ------------------------------------------------------------------ */
 
-      void ImpulsBerechnen(void)     // Bezogen auf CellCenter!
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppeSemiLagrange
+      ----------------------------------------------------------------------- */
+
+      void Kontext::FeldgruppeSemiLagrange(int l)  // Wie SemiLagrangeZeitschritt für Gruppe l
      {
 
-      int i;  // Schleifenzähler
+   /* Randbedingungen und Abfahrtspunkte werden wie in
+      FeldgruppenKoeffizienten vorübergehend mit denen der Gruppe
+      vertauscht. Die Parameter der dynamischen Ränder stehen für jedes
+      Feld ab p[8] und p[14] in derselben Reihenfolge wie wF, w1..w4. */
+
+      int k;          // Lokaler Schleifenzähler
+      int K;          // Anzahl der Felder der Gruppe
+
+      double *q;      // Parameter des Feldes k
+      double *r;      // Feld k
+
+      Feldgruppe *G;  // Gruppe l
+
+      G = FG + l; K = G->K;
 
-      for (i=imin;i<=imax;i++) f[i] = rho[i]*u[i];
+      swap(RBW,G->RBW); swap(RBO,G->RBO);
+      swap(dZ ,G->dZ ); swap(dK ,G->dK ); swap(dA ,G->dA );
+      swap(vW ,G->vW ); swap(vO ,G->vO );
 
-      px = VolumenIntegration(f);
+      for (k=0;k<K;k++) SemiLagrangeTransport( G->rho + k, K, G->p + 19*k + 8, G->p + 19*k + 14 );
 
+      swap(RBW,G->RBW); swap(RBO,G->RBO);
+      swap(dZ ,G->dZ ); swap(dK ,G->dK ); swap(dA ,G->dA );
+      swap(vW ,G->vW ); swap(vO ,G->vO );
+
+   /* Geisterzellen */
+
+      for (k=0;k<K;k++)
+     {
+      q = G->p + 19*k; r = G->rho + k;
+      if ( G->RBW == DynamicBoundary  ) r[(imin-1)*K] = q[12]*(this->*Funktion[(int)q[ 8]])( ( t - q[ 9] )/q[11] ) + q[10];
+      if ( G->RBO == DynamicBoundary  ) r[(imax+1)*K] = q[18]*(this->*Funktion[(int)q[14]])( ( t - q[15] )/q[17] ) + q[16];
+      if ( G->RBW == NeumannBoundary  ) r[(imin-1)*K] = r[imin*K] - G->g[2*k  ]*( x[ imin ] - x[imin-1] );
+      if ( G->RBO == NeumannBoundary  ) r[(imax+1)*K] = r[imax*K] + G->g[2*k+1]*( x[imax+1] - x[ imax ] );
+      if ( G->RBW == PeriodicBoundary ) { r[(imin-1)*K] = r[imax*K]; r[(imax+1)*K] = r[imin*K]; }
      }
 
-   /* ------------------------------------------------------------------
-      Ende von ImpulsBerechnen
-      ------------------------------------------------------------------ */
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppeSemiLagrange
+      ----------------------------------------------------------------------- */
 
 
 
    /* -----------------------------------------------------------------------
-      Anfang von ImpliziterZeitschrittPBC
+      Anfang von FeldgruppeRechteSeite
       ----------------------------------------------------------------------- */
 
-      void ImpliziterZeitschrittPBC(void)
+      void Kontext::FeldgruppeRechteSeite(int l)  // Wie RechteSeiteBerechnen für Gruppe l
      {
 
-      int i, K ; // Schleifenzähler
+   /* Bei BDF2 wird rV nach der rechten Seite mit rho^n überschrieben und
+      ist damit für den nächsten Schritt rho^(n-1). Beim Theta-Verfahren ist
+      rV nur eine Kopie von rho^n einschließlich der Geisterzellen. */
 
-      double D, df;
+      int i, k;       // Lokale Schleifenzähler
+      int K;          // Anzahl der Felder der Gruppe
 
-   /* Startlösung zu K = 0 für Gauß-Seidel erzeugen */
+      double h, c;
 
-      for (i=imin-1;i<=imax+1;i++)
+      double *r, *v;  // Felder und alte Werte der Zelle i
+
+      Feldgruppe *G;  // Gruppe l
+
+      G = FG + l; K = G->K;
+
+      if ( ZV == BDF2Scheme )
+      for (i=imin;i<=imax;i++)
      {
-      f[i] = rho[i];
+      r = G->rho + i*K; v = G->rV + i*K;
+      #pragma omp simd private(h)
+      for (k=0;k<K;k++) { h = r[k]; r[k] = ( bB != 0.0 ) ? bA*h - bB*v[k] : h; v[k] = h; }
      }
 
-   /* ------------------------------------------------------------------ */
-
-      for (K=0;K<IMAX;K++)          // Anfang innere Iterationen
-     {                              
-                                    
-      D  = 0.0;                     // Defekt auf Null setzen
-                                    
-      f[imin-1] = f[imax];          // Geisterzelle West ohne Defektberechnung (Pragmatismus)
-                                    
-      for (i=imin;i<=imax;i++)      // Innere Zellen mit Defektberechnung
+      if ( ZV == ThetaScheme )
      {
-      df = -( aW[i]*f[i-1] + aE[i]*f[i+1] - rho[i]   ) /aP[i] - f[i];
-      f[i] += df;
-      D  = (fabs(df)>D) * fabs(df) + (fabs(df)<=D) * D;   // if-Verzweigung vermeiden
+      c = ( 1.0 - th )/th;
+      for (i=0;i<(imax+2)*K;i++) G->rV[i] = G->rho[i];
+      for (i=imin;i<=imax;i++)
+     {
+      r = G->rho + i*K; v = G->rV + i*K;
+      #pragma omp simd
+      for (k=0;k<K;k++) r[k] = v[k] - c*( G->aW[i]*v[k-K] + ( G->aP[i] - 1.0 )*v[k] + G->aE[i]*v[k+K] );
+     }
      }
 
-      f[imax+1] = f[imin];          // Geisterzelle Ost ohne Defektberechnung (Pragmatismus)
-                                    
-      if ( D < delta ) break;       // D = 0 in Ausgabe vermeiden, daher hier break!
-                                    
-      Dout << D << "\n";            // ln-Skala: D > 0 hier!
-                                    
-     }                              // Ende innere Iterationen
+     }
 
-   /* ------------------------------------------------------------------ */
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppeRechteSeite
+      ----------------------------------------------------------------------- */
 
-      for (i=imin-1;i<=imax+1;i++)  // Rückspeichern
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FeldgruppenMasseSchreiben
+      ----------------------------------------------------------------------- */
+
+      void Kontext::FeldgruppenMasseSchreiben(ofstream &MEout, ofstream &MSout, double Zeit)
      {
-      rho[i] = f[i];
+
+      int i, j, l;    // Lokale Schleifenzähler
+
+      Feldgruppe *G;  // Aktuelle Gruppe
+
+      for (l=0;l<nG;l++)
+     {
+
+      G = FG + l;
+
+      for (j=0;j<G->K;j++) G->s[j] = 0.0;
+
+      for (i=imin;i<=imax;i++)
+     {
+      #pragma omp simd
+      for (j=0;j<G->K;j++) G->s[j] += G->rho[i*G->K+j]*dx[i];
      }
 
-      if (K==IMAX) NMAX++ ;
+     }
+
+      for (j=0;j<nF;j++) mF[j] = FG[gF[j]].s[kF[j]];
+
+      if ( EM > 0 ) { MEout << Zeit; for (j= 0;j<EM;j++) MEout << " " << mF[j]; MEout << "\n"; }
+      if ( NS > 0 ) { MSout << Zeit; for (j=EM;j<nF;j++) MSout << " " << mF[j]; MSout << "\n"; }
 
      }
 
    /* -----------------------------------------------------------------------
-      Ende von ImpliziterZeitschrittPBC
+      Ende von FeldgruppenMasseSchreiben
       ----------------------------------------------------------------------- */
 
 
 
    /* -----------------------------------------------------------------------
-      Anfang von ImpliziterZeitschrittSTD
+      Anfang von FeldgruppenSpeichern
       ----------------------------------------------------------------------- */
 
-      void ImpliziterZeitschrittSTD(void)
+      void Kontext::FeldgruppenSpeichern(void)
      {
 
-      int i, K ; // Schleifenzähler
+      if ( EM > 0 ) FelderSpeichern( 0,EM,"rhoE.out","BoundaryE.out");
+      if ( NS > 0 ) FelderSpeichern(EM,nF,"rhoS.out","BoundaryS.out");
 
-      double D, df;
+     }
 
-   /* Startlösung für Gauß-Seidel erzeugen */
+   /* -----------------------------------------------------------------------
+      Ende von FeldgruppenSpeichern
+      ----------------------------------------------------------------------- */
 
-      for (i=imin-1;i<=imax+1;i++)
-     {
-      f[i] = rho[i];
-     }
 
-   /* DynamicBoundary für neuen Zeitschritt auswerten */
 
-      if ( RBW == DynamicBoundary ) f[imin-1] = w4*W0( ( t - w1 )/w3 ) + w2;
-      if ( RBO == DynamicBoundary ) f[imax+1] = o4*O0( ( t - o1 )/o3 ) + o2;
+   /* -----------------------------------------------------------------------
+      Anfang von FelderSpeichern
+      ----------------------------------------------------------------------- */
 
-      for (K=0;K<IMAX;K++)  // Innere Iterationen
+      void Kontext::FelderSpeichern(int ja, int je, const char *Name, const char *Rand)
      {
 
-      D  = 0.0;  // Geisterzellen ohne Defektberechnung (Pragmatismus)
+   /* Zusatzfelder ja..je-1: je Zeile x und die Werte der Felder,
+      Geisterzellen separat (erst West, dann Ost) */
 
-      if ( RBW == NeumannBoundary ) SetGradient( f, imin, dxrhoW );
+      int i, j;       // Lokale Schleifenzähler
 
-   /* Die i-te Gleichung: aW[i]*f[i-1] + aP[i]*f[i] + aE[i]*f[i+1] = rho[i] */
+      ofstream fout;
+
+      fout << setiosflags(ios::scientific) << setprecision(13);
 
+      fout.open(Pfad + Name);
       for (i=imin;i<=imax;i++)
      {
-      df = ( rho[i] - aW[i]*f[i-1] - aE[i]*f[i+1] ) / aP[i] - f[i];
-      f[i] += df;
-      if (fabs(df)>D ) D  = fabs(df);
+      fout << x[i];
+      for (j=ja;j<je;j++) fout << " " << FG[gF[j]].rho[i*FG[gF[j]].K+kF[j]];
+      fout << "\n";
+     }
+      fout.close();
+
+      fout.open(Pfad + Rand);
+      for (j=ja;j<je;j++) fout << FG[gF[j]].rho[(imin-1)*FG[gF[j]].K+kF[j]] << "\n";
+      for (j=ja;j<je;j++) fout << FG[gF[j]].rho[(imax+1)*FG[gF[j]].K+kF[j]] << "\n";
+      fout.close();
+
      }
 
-      if ( RBO == NeumannBoundary ) SetGradient( rho, imax, dxrhoO );
+   /* -----------------------------------------------------------------------
+      Ende von FelderSpeichern
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von FelderEinlesen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::FelderEinlesen(int ja, int je, const char *Name, const char *Rand)
+     {
 
-      if ( D < delta ) break;
+      int i, j;       // Lokale Schleifenzähler
 
-      Dout << D << "\n";  // ln-Skala: D = 0 vermeiden, daher Dout nach break
+      double h;       // Ortskoordinate überlesen
 
-     }
+      ifstream fin;
 
-      for (i=0;i<=imax;i++)  // Rückspeichern
+      fin.open(Pfad + Name);
+      for (i=imin;i<=imax;i++)
      {
-      rho[i] = f[i];
+      fin >> h;
+      for (j=ja;j<je;j++) fin >> FG[gF[j]].rho[i*FG[gF[j]].K+kF[j]];
      }
+      fin.close();
 
-      if (K==IMAX) NMAX++ ;
+      fin.open(Pfad + Rand);
+      for (j=ja;j<je;j++) fin >> FG[gF[j]].rho[(imin-1)*FG[gF[j]].K+kF[j]];
+      for (j=ja;j<je;j++) fin >> FG[gF[j]].rho[(imax+1)*FG[gF[j]].K+kF[j]];
+      fin.close();
 
      }
 
    /* -----------------------------------------------------------------------
-      Ende von ImpliziterZeitschrittSTD
+      Ende von FelderEinlesen
       ----------------------------------------------------------------------- */
 
 
@@ -1260,7 +6759,7 @@
       Anfang von Konstante
       ------------------------------------------------------------------ */
 
-      double Konstante(double x)
+      double Kontext::Konstante(double x)
      {
       return 1.0;
      }
@@ -1275,7 +6774,7 @@
       Anfang von Linear
       ------------------------------------------------------------------ */
 
-      double Linear(double x)
+      double Kontext::Linear(double x)
      {
       return x;
      }
@@ -1290,7 +6789,7 @@
       Anfang von Parabel
       ------------------------------------------------------------------ */
 
-      double Parabel(double x)
+      double Kontext::Parabel(double x)
      {
       return x*x;
      }
@@ -1305,7 +6804,7 @@
       Anfang von Rechteck
       ------------------------------------------------------------------ */
 
-      double Rechteck(double x)
+      double Kontext::Rechteck(double x)
      {
       if ( x <= -0.5 ) return 0.0;  // Wegen Normierung auf 1 hier <=
       if ( x >   0.5 ) return 0.0;
@@ -1322,7 +6821,7 @@
       Anfang von Dreieck
       ------------------------------------------------------------------ */
 
-      double Dreieck(double x)
+      double Kontext::Dreieck(double x)
      {
       if ( x <= -1.0 ) return 0.0;
       if ( x <=  0.0 ) return 1.0 + x;
@@ -1340,7 +6839,7 @@
       Anfang von Saegezahn
       ------------------------------------------------------------------ */
 
-      double Saegezahn(double x)
+      double Kontext::Saegezahn(double x)
      {
       if ( x <=  0.0 ) return 0.0;
       if ( x <= +1.0 ) return x;
@@ -1357,7 +6856,7 @@
       Anfang von Linearrampe
       ------------------------------------------------------------------ */
 
-      double Linearrampe(double x)
+      double Kontext::Linearrampe(double x)
      {
       if ( x <=  0.0 ) return 0.0;
       if ( x <= +1.0 ) return x;
@@ -1374,7 +6873,7 @@
       Anfang von Cosinusrampe
       ------------------------------------------------------------------ */
 
-      double Cosinusrampe(double x)
+      double Kontext::Cosinusrampe(double x)
      {
       if ( x <=  0.0 ) return 0.0;
       if ( x <= +1.0 ) return 0.5*(1.0-cos(Pi*x));
@@ -1391,7 +6890,7 @@
       Anfang von Sinus
       ------------------------------------------------------------------ */
 
-      double Sinus(double x)
+      double Kontext::Sinus(double x)
      {
       return sin(2.0*Pi*x);
      }
@@ -1406,7 +6905,7 @@
       Anfang von Cosinus
       ------------------------------------------------------------------ */
 
-      double Cosinus(double x)
+      double Kontext::Cosinus(double x)
      {
       return cos(2.0*Pi*x);
      }
@@ -1421,7 +6920,7 @@
       Anfang von CosPeak
       ------------------------------------------------------------------ */
 
-      double CosPeak(double x)
+      double Kontext::CosPeak(double x)
      {
       if ( x <= -0.5 ) return 0.0;
       if ( x >=  0.5 ) return 0.0;
@@ -1438,7 +6937,7 @@
       Anfang von Exponential
       ------------------------------------------------------------------ */
 
-      double Exponential(double x)
+      double Kontext::Exponential(double x)
      {
       return exp(x);
      }
@@ -1453,7 +6952,7 @@
       Anfang von Gauss
       ------------------------------------------------------------------ */
 
-      double Gauss(double x) // Funktion ist normiert!
+      double Kontext::Gauss(double x) // Funktion ist normiert!
      {
 
       return exp(-x*x*Pi);
@@ -1470,7 +6969,7 @@
       Anfang von Dirac
       ------------------------------------------------------------------ */
 
-      double Dirac(double x)           // Funktion ist für äquidistantes
+      double Kontext::Dirac(double x)           // Funktion ist für äquidistantes
      {                                 //  Gitter normiert!
 
       if ( x == 0.0 ) return 1.0/dx[0];
@@ -1488,7 +6987,7 @@
       Anfang von Heaviside
       ------------------------------------------------------------------ */
 
-      double Heaviside(double x)
+      double Kontext::Heaviside(double x)
      {
       if ( x < 0.0 ) return 0.0; 
                      return 1.0;
@@ -1504,7 +7003,7 @@
       Anfang von UserDefined01
       ------------------------------------------------------------------ */
 
-      double UserDefined01(double x)
+      double Kontext::UserDefined01(double x)
      {
       double y; 
      #include "./UserDef01.txt"   
@@ -1522,7 +7021,7 @@
       Anfang von UserDefined02
       ------------------------------------------------------------------ */
 
-      double UserDefined02(double x)
+      double Kontext::UserDefined02(double x)
      {
       double y; 
      #include "./UserDef02.txt"   
@@ -1540,7 +7039,7 @@
       Anfang von GetGradient
       ----------------------------------------------------------------------- */
 
-      void GetGradient(double *m, int i, double &Value)
+      void Kontext::GetGradient(double *m, int i, double &Value)
      {
 
       if (i == imin) Value =  ( m[ i ] - m[i-1] ) / ( x[ i ] - x[i-1] );
@@ -1558,7 +7057,7 @@
       Anfang von SetGradient
       ----------------------------------------------------------------------- */
 
-      void SetGradient(double *m, int i, double Value)
+      void Kontext::SetGradient(double *m, int i, double Value)
      {
 
       if (i==imin) m[i-1] = m[i] - Value * ( x[ i ] - x[i-1] );
@@ -1569,3 +7068,445 @@
    /* -----------------------------------------------------------------------
       Ende von SetGradient
       ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DefektProtokollStarten
+      ----------------------------------------------------------------------- */
+
+      void Kontext::DefektProtokollStarten(void)
+     {
+
+   /* Bei DL = 2 schreibt der Löser jeden Defekt in einen Ringpuffer, ein
+      Hintergrund-Thread leert ihn binär nach D.bin. Der Löser wartet nur,
+      wenn der Puffer voll ist. Format: 8 Zeichen Kennung "KONTI-D1",
+      danach double-Werte; auf die Defekte des Zeitschritts n folgt -n. */
+
+      DR.Laenge = 1 << 20;
+      DR.Wert   = new double[DR.Laenge];
+
+      DR.Kopf   = 0;
+      DR.Ende   = 0;
+      DR.Aktiv  = true;
+
+      if (AZ!=0) DR.Datei.open(Pfad + "D.bin",ios::binary|ios::app);
+      else     { DR.Datei.open(Pfad + "D.bin",ios::binary); DR.Datei.write("KONTI-D1",8); }
+
+      DR.Schreiber = thread(&Kontext::DefektSchreiber,this);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DefektProtokollStarten
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DefektProtokollBeenden
+      ----------------------------------------------------------------------- */
+
+      void Kontext::DefektProtokollBeenden(void)
+     {
+
+      DR.Aktiv = false;      // Schreib-Thread leert den Rest und endet
+
+      DR.Schreiber.join();
+
+      DR.Datei.close();
+
+      delete [] DR.Wert;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DefektProtokollBeenden
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DefektSpeichern
+      ----------------------------------------------------------------------- */
+
+      void Kontext::DefektSpeichern(double D)
+     {
+
+      size_t h;  // Schreibposition
+
+      if ( DL != FullLog ) return;
+
+      h = DR.Kopf.load(memory_order_relaxed);
+
+      while ( h - DR.Ende.load(memory_order_acquire) >= DR.Laenge ) this_thread::yield();  // Puffer voll
+
+      DR.Wert[h & (DR.Laenge-1)] = D;
+
+      DR.Kopf.store(h+1,memory_order_release);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DefektSpeichern
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von DefektSchreiber
+      ----------------------------------------------------------------------- */
+
+      void Kontext::DefektSchreiber(void)  // Läuft im Hintergrund-Thread
+     {
+
+      size_t k, e, a, b;  // Kopf, Ende, Anfang und Ende eines Blocks
+      bool aktiv;
+
+      e = DR.Ende.load(memory_order_relaxed);
+
+      while ( true )
+     {
+
+      aktiv = DR.Aktiv;                             // Erst Aktiv, dann Kopf lesen
+      k     = DR.Kopf.load(memory_order_acquire);
+
+      if ( k == e )
+     {
+      if ( !aktiv ) break;
+      this_thread::sleep_for(chrono::milliseconds(1));
+      continue;
+     }
+
+      while ( e < k )                              // Zusammenhängende Blöcke schreiben
+     {
+      a = e & (DR.Laenge-1);
+      b = a + (k-e); if ( b > DR.Laenge ) b = DR.Laenge;
+      DR.Datei.write((char*)(DR.Wert+a),(b-a)*sizeof(double));
+      e += b-a;
+     }
+
+      DR.Ende.store(e,memory_order_release);
+
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von DefektSchreiber
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von GitterPruefsumme
+      ----------------------------------------------------------------------- */
+
+      unsigned long long Kontext::GitterPruefsumme(void)  // FNV-1a über x und dx
+     {
+
+      int i;                  // Schleifenzähler
+      size_t j;               // Byte-Zähler
+
+      unsigned long long h;   // Prüfsumme
+      unsigned char *b;       // Bytes eines Wertes
+
+      h = 14695981039346656037ULL;
+
+      for (i=imin-1;i<=imax+1;i++)
+     {
+      b = (unsigned char*)&x [i]; for (j=0;j<sizeof(double);j++) { h ^= b[j]; h *= 1099511628211ULL; }
+      b = (unsigned char*)&dx[i]; for (j=0;j<sizeof(double);j++) { h ^= b[j]; h *= 1099511628211ULL; }
+     }
+
+      return h;
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von GitterPruefsumme
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von CheckpointLaenge
+      ----------------------------------------------------------------------- */
+
+      size_t Kontext::CheckpointLaenge(void)
+     {
+
+   /* Aufbau der Datei konti.chk (Version 4, native Byte-Reihenfolge):
+
+           char[8]  "KONTICHK"
+           int      Version, imax, RBW, RBO, nF, NMAX, nA, ZV
+           uint64   Zeitschritt n, Prüfsumme des Gitters
+           double   t0, ta, dt, dxrhoW, dxrhoO, t, dtV, dtVV
+           double   u[0..imax+1], rho[0..imax+1]
+           double   rhoA[0..imax+1], rhoB[0..imax+1] (davon nA gültig)
+           double   nF Zusatzfelder [0..imax+1], je Feld 2 Gradienten
+           double   nF Zusatzfelder der Zeitebene davor (gültig bei ZV = 1) */
+
+      return 8 + 8*sizeof(int) + 2*sizeof(unsigned long long)
+               + ( 8 + 4*(imax+2) + 2*nF*(imax+2) + 2*nF )*sizeof(double);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von CheckpointLaenge
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von CheckpointStarten
+      ----------------------------------------------------------------------- */
+
+      void Kontext::CheckpointStarten(void)
+     {
+
+      CS.Laenge    = CheckpointLaenge();
+      CS.Puffer[0] = new char[CS.Laenge];
+      CS.Puffer[1] = new char[CS.Laenge];
+      CS.Status[0] = 0;
+      CS.Status[1] = 0;
+      CS.Aktuell   = 0;
+      CS.Ende      = false;
+
+      CS.Schreiber = thread(&Kontext::CheckpointSchreiber,this);
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von CheckpointStarten
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von CheckpointBeenden
+      ----------------------------------------------------------------------- */
+
+      void Kontext::CheckpointBeenden(void)
+     {
+
+     {
+      lock_guard<mutex> l(CS.m);
+      CS.Ende = true;
+     }
+
+      CS.c.notify_all();
+
+      CS.Schreiber.join();
+
+      delete [] CS.Puffer[0];
+      delete [] CS.Puffer[1];
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von CheckpointBeenden
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von CheckpointSchreiben
+      ----------------------------------------------------------------------- */
+
+      void Kontext::CheckpointSchreiben(unsigned long Schritt)
+     {
+
+   /* Der Zustand wird nur in einen freien Puffer kopiert, das Schreiben
+      übernimmt der Hintergrund-Thread. Gewartet wird nur, wenn beide
+      Puffer noch nicht geschrieben sind. */
+
+      int i, j, k;            // Schleifenzähler
+      int Kopf[8];            // Ganzzahlige Kopfdaten
+      unsigned long long L[2];// Zeitschritt und Prüfsumme
+      double T[8];            // Zeiten, Gradienten und Schrittweiten
+
+      char *b;                // Schreibposition im Puffer
+
+      k = CS.Aktuell;
+
+     {
+      unique_lock<mutex> l(CS.m);
+      while ( CS.Status[k] != 0 ) CS.c.wait(l);
+     }
+
+      b = CS.Puffer[k];
+
+      Kopf[0] = 4; Kopf[1] = imax; Kopf[2] = RBW; Kopf[3] = RBO; Kopf[4] = nF; Kopf[5] = NMAX; Kopf[6] = ( nA < 2 ) ? nA : 2;
+      Kopf[7] = ZV;
+
+      L[0] = Schritt;
+      L[1] = GitterPruefsumme();
+
+      T[0] = t0; T[1] = ta; T[2] = dt; T[3] = dxrhoW; T[4] = dxrhoO; T[5] = t; T[6] = dtV; T[7] = dtVV;
+
+      memcpy(b,"KONTICHK",8);         b += 8;
+      memcpy(b,Kopf,sizeof(Kopf));    b += sizeof(Kopf);
+      memcpy(b,L   ,sizeof(L   ));    b += sizeof(L   );
+      memcpy(b,T   ,sizeof(T   ));    b += sizeof(T   );
+      memcpy(b,u   ,(imax+2)*sizeof(double)); b += (imax+2)*sizeof(double);
+      memcpy(b,rho ,(imax+2)*sizeof(double)); b += (imax+2)*sizeof(double);
+      memcpy(b,rhoA,(imax+2)*sizeof(double)); b += (imax+2)*sizeof(double);
+      memcpy(b,rhoB,(imax+2)*sizeof(double)); b += (imax+2)*sizeof(double);
+
+      for (j=0;j<nF;j++) for (i=imin-1;i<=imax+1;i++)
+     {
+      memcpy(b,&FG[gF[j]].rho[i*FG[gF[j]].K+kF[j]],sizeof(double)); b += sizeof(double);
+     }
+
+      for (j=0;j<nF;j++)
+     {
+      memcpy(b,&FG[gF[j]].g[2*kF[j]],2*sizeof(double)); b += 2*sizeof(double);
+     }
+
+      for (j=0;j<nF;j++) for (i=imin-1;i<=imax+1;i++)
+     {
+      memcpy(b,&FG[gF[j]].rV[i*FG[gF[j]].K+kF[j]],sizeof(double)); b += sizeof(double);
+     }
+
+     {
+      lock_guard<mutex> l(CS.m);
+      CS.Status[k] = 1;
+      CS.Aktuell   = 1 - k;  // Unter der Sperre: der Schreiber sucht damit den älteren Puffer
+     }
+
+      CS.c.notify_all();
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von CheckpointSchreiben
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von CheckpointSchreiber
+      ----------------------------------------------------------------------- */
+
+      void Kontext::CheckpointSchreiber(void)  // Läuft im Hintergrund-Thread
+     {
+
+      int k;          // Zu schreibender Puffer
+
+      ofstream fout;
+
+      while ( true )
+     {
+
+     {
+      unique_lock<mutex> l(CS.m);
+      while ( CS.Status[0] != 1 && CS.Status[1] != 1 && !CS.Ende ) CS.c.wait(l);
+      if ( CS.Status[0] != 1 && CS.Status[1] != 1 ) break;      // Ende und nichts mehr zu tun
+      k = ( CS.Status[0] == 1 ) ? 0 : 1;
+      if ( CS.Status[1-k] == 1 ) k = CS.Aktuell;                   // Ältesten Puffer zuerst
+      CS.Status[k] = 2;
+     }
+
+   /* Erst vollständig schreiben, dann umbenennen: konti.chk ist immer gültig */
+
+      fout.open(Pfad + "konti.chk.tmp",ios::binary);
+      fout.write(CS.Puffer[k],CS.Laenge);
+      fout.close();
+
+      rename( (Pfad + "konti.chk.tmp").c_str(), (Pfad + "konti.chk").c_str() );
+
+     {
+      lock_guard<mutex> l(CS.m);
+      CS.Status[k] = 0;
+     }
+
+      CS.c.notify_all();
+
+     }
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von CheckpointSchreiber
+      ----------------------------------------------------------------------- */
+
+
+
+   /* -----------------------------------------------------------------------
+      Anfang von CheckpointEinlesen
+      ----------------------------------------------------------------------- */
+
+      void Kontext::CheckpointEinlesen(void)
+     {
+
+      int Kopf[8];            // Ganzzahlige Kopfdaten
+      unsigned long long L[2];// Zeitschritt und Prüfsumme
+      double T[8];            // Zeiten, Gradienten und Schrittweiten
+      char Kennung[8];        // Dateikennung
+
+      ifstream fin;
+
+      fin.open(Pfad + "konti.chk",ios::binary);
+
+      fin.read(Kennung,8);
+      fin.read((char*)Kopf,sizeof(Kopf));
+      fin.read((char*)L   ,sizeof(L   ));
+      fin.read((char*)T   ,sizeof(T   ));
+
+      if ( !fin || memcmp(Kennung,"KONTICHK",8) != 0 || Kopf[0] != 4 )
+     {
+      *Konsole << "\n >> Fehler: \"konti.chk\" fehlt oder hat ein unbekanntes Format !\n\n";
+      abort();
+     }
+
+      if ( Kopf[1] != imax || Kopf[2] != RBW || Kopf[3] != RBO || Kopf[4] != nF || L[1] != GitterPruefsumme() )
+     {
+      *Konsole << "\n >> Fehler: \"konti.chk\" passt nicht zu Gitter, Randbedingungen oder Zusatzfeldern !\n\n";
+      abort();
+     }
+
+      NMAX   = Kopf[5];
+      nA     = Kopf[6];
+      t0     = T[0];
+      dxrhoW = T[3];
+      dxrhoO = T[4];
+      dtV    = T[6];  // Alte Zeitebenen bleiben gültig, BDF2 und Prädiktor
+      dtVV   = T[7];  // rechnen mit den tatsächlichen Schrittweiten weiter
+
+      if ( T[2] == dt && ZA == FixedTimeStep ) { ta = T[1]; n0 = L[0]; }   // Zeitpunkte bitgenau fortsetzen
+      else { ta = T[5]; n0 = 0; }  // Neues oder adaptives dt: ab dem Checkpoint zählen
+
+      if ( nA > 0 && dtV  <= 0.0 && n0 == 0 ) nA = 0;  // Schrittweiten unbekannt (Parareal)
+      if ( nA > 1 && dtVV <= 0.0 && n0 == 0 ) nA = 1;
+
+      if ( ZV == BDF2Scheme && Kopf[7] != BDF2Scheme ) nA = 0;  // Zeitebene davor fehlt
+
+      fin.read((char*)u  ,(imax+2)*sizeof(double));
+      fin.read((char*)rho,(imax+2)*sizeof(double));
+      fin.read((char*)rhoA,(imax+2)*sizeof(double));
+      fin.read((char*)rhoB,(imax+2)*sizeof(double));
+
+      chkF = new double[nF*(imax+2)+1];
+      chkG = new double[2*nF+1];
+
+      fin.read((char*)chkF,nF*(imax+2)*sizeof(double));
+      fin.read((char*)chkG,2*nF*sizeof(double));
+
+      chkV = new double[nF*(imax+2)+1];
+
+      fin.read((char*)chkV,nF*(imax+2)*sizeof(double));
+
+      if ( !fin )  // Datei kürzer als die Kopfdaten angeben
+     {
+      *Konsole << "\n >> Fehler: \"konti.chk\" ist unvollständig !\n\n";
+      abort();
+     }
+
+      fin.close();
+
+     }
+
+   /* -----------------------------------------------------------------------
+      Ende von CheckpointEinlesen
+      ----------------------------------------------------------------------- */
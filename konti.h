@@ -0,0 +1,79 @@
+   /* -----------------------------------------------------------------------
+
+      Programm:   konti (Bibliotheksschnittstelle)
+
+      Sprache:    ANSI C++
+
+      Lizenz:     GNU GPL v3.0
+
+      -----------------------------------------------------------------------
+
+      Mit -DKONTI_BIBLIOTHEK übersetzt enthält konti.cpp kein main, und ein
+      anderes Programm kann den Löser direkt aufrufen:
+
+           g++ -O2 -fopenmp -pthread -DKONTI_BIBLIOTHEK -c konti.cpp
+           g++ -O2 -fopenmp -pthread Koppler.cpp konti.o
+
+      Ablauf:
+
+           Kontext *K = KontiErzeugen(Eingabe);   // wie input.dat
+           double *rho = KontiDichte(K);          // rho[0] ... rho[imax+1]
+           rho[0] = ...;                          // Geisterzelle West setzen
+           KontiRechnen(K,10);                    // 10 Zeitschritte
+           ... rho lesen ...
+           KontiLoeschen(K);
+
+      Alle Felder haben imax+2 Werte: Index 0 und imax+1 sind die
+      Geisterzellen, 1 bis imax die Zellmittelpunkte. Die Zeiger zeigen auf
+      die Felder des Lösers selbst und bleiben bis KontiLoeschen gültig,
+      kopiert wird nichts. Wer x, dx oder u ändert, ruft danach
+      KontiGeaendert auf, damit der nächste Zeitschritt Koeffizienten und
+      Zerlegung neu berechnet. rho darf zwischen zwei Aufrufen von
+      KontiRechnen beliebig geändert werden.
+
+      Die Bibliothek schreibt keine Ausgabedateien und rechnet immer seriell
+      in der Zeit (PZ = 0), ohne Defektprotokoll (DL = 0) und ohne
+      Checkpoints (CP = 0). KontiRechnen führt weniger als n Zeitschritte
+      nur bei ZA = 1 aus, wenn der Endzeitpunkt te erreicht ist. Fehler
+      in den Parametern beenden den Prozess nicht: KontiErzeugen prüft sie
+      wie der Dienst (konti -s) vorab und liefert dann NULL.
+
+      ----------------------------------------------------------------------- */
+
+     #ifndef KONTI_H
+     #define KONTI_H
+
+     #include <ostream>
+
+      struct Kontext;  // Ein Rechenlauf, Inhalt nur in konti.cpp bekannt
+
+   /* Eingabe:   Inhalt im Format von input.dat (NULL: input.dat lesen)
+      Aenderung: "Name=Wert ..." wie in einer Parameterstudie (NULL: keine)
+      Gitter:    x und dx je Zelle wie in mesh.dat, setzt mesh = 1 (NULL: ohne)
+      Meldungen: Ziel der Bildschirmausgabe (NULL: keine Meldungen)
+
+      Liefert NULL und schreibt den Grund nach Meldungen, wenn Aenderung
+      fehlerhaft ist, ein Parameter unzulässig ist (Versionsnummer, RBW,
+      RBO, TV, uF, rF, wF, oF, imax, ensemble.dat und skalare.dat bei
+      EM, NS > 0) oder nGitter < 2*(imax+2) ist. */
+
+      Kontext      *KontiErzeugen        (const char *Eingabe,
+                                          const char *Aenderung = NULL,
+                                          const double *Gitter = NULL, int nGitter = 0,
+                                          std::ostream *Meldungen = NULL);
+
+      void          KontiLoeschen        (Kontext *K);
+
+      int           KontiZellen          (Kontext *K);  // imax
+
+      double       *KontiGitterX         (Kontext *K);  // Zellmittelpunkte
+      double       *KontiGitterDX        (Kontext *K);  // Gitterabstände
+      double       *KontiGeschwindigkeit (Kontext *K);  // u
+      double       *KontiDichte          (Kontext *K);  // rho
+
+      void          KontiGeaendert       (Kontext *K);  // Nach Änderung von x, dx oder u
+
+      unsigned long KontiRechnen         (Kontext *K, unsigned long n);  // Ausgeführte Schritte
+      double        KontiZeit            (Kontext *K);  // Zeitpunkt von rho
+
+     #endif